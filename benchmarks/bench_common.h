@@ -0,0 +1,62 @@
+#ifndef TAGHA_BENCH_COMMON_INCLUDED
+#	define TAGHA_BENCH_COMMON_INCLUDED
+
+/** Helpers shared by the benchmarks.
+ * define `_POSIX_C_SOURCE` before including it so `clock_gettime` is declared.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../tagha_toolchain/module_gen.h"
+#include "../tagha_toolchain/instr_gen.h"
+
+
+static inline double bench_now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline union TaghaVal bench_imm(const uint64_t u)
+{
+	return ( union TaghaVal ){ .uint64 = u };
+}
+
+/// both stacks get 'stack_size' bytes.
+static inline struct TaghaModGen bench_mod_gen(const uint32_t stack_size, const uint32_t heap_size)
+{
+	struct TaghaModGen modgen = tagha_mod_gen_create();
+	tagha_mod_gen_write_header(&modgen, stack_size, stack_size, heap_size, 0);
+	return modgen;
+}
+
+/// jumps back to the instruction at 'target' while the last `cmp` wasn't equal.
+static inline NO_NULL void bench_jz_back(struct HarbolByteBuf *const code, const size_t target)
+{
+	const size_t jump_len = tagha_instr_gen(NULL, jz, 0);
+	tagha_instr_gen(code, jz, ( int32_t )target - ( int32_t )(code->count + jump_len));
+}
+
+/// callbacks may run on worker threads so the totals are added atomically.
+struct BenchTotals {
+	volatile size_t sum, count, errs;
+};
+
+static inline void bench_on_done(void *const data, struct TaghaModule *const module, const int err, const union TaghaVal result)
+{
+	struct BenchTotals *const totals = data;
+	( void )module;
+	harbol_atomic_fetch_add_size(&totals->sum, result.size);
+	harbol_atomic_fetch_add_size(&totals->count, 1);
+	if( err != TaghaErrNone )
+		harbol_atomic_fetch_add_size(&totals->errs, 1);
+}
+
+static inline NO_NULL void bench_print(const char label[const static 1], const double ns, const size_t ops, const bool matches)
+{
+	printf("%-24s | %9.2f | %10.2f%s\n", label, ns / 1e6, ops / (ns / 1e3), matches ? "" : " (result mismatch!)");
+}
+
+#endif /** TAGHA_BENCH_COMMON_INCLUDED */
@@ -0,0 +1,123 @@
+#define _POSIX_C_SOURCE 199309L
+#include "bench_common.h"
+
+/** Huge page benchmark.
+ * loads a module with a large heap under different load flags,
+ * fills a table in its heap, then times a script doing random reads over it.
+ */
+
+enum {
+	BENCH_TABLE_SIZE  = 256 * 1024 * 1024,
+	BENCH_STACK_SIZE  = 0x1000,
+	BENCH_WALK_ITERS  = 5000000,
+	BENCH_WALK_RUNS   = 3,
+};
+
+/** uint64_t walk(const uint64_t table[], uint64_t mask, uint64_t iters) {
+ *     uint64_t sum = 0, state = 1;
+ *     do {
+ *         state = state * 6364136223846793005 + 1442695040888963407;
+ *         sum += table[(state >> 33) & mask];
+ *     } while( --iters != 0 );
+ *     return sum;
+ * }
+ */
+static uint8_t *bench_make_module(void)
+{
+	struct TaghaModGen modgen = bench_mod_gen(BENCH_STACK_SIZE, BENCH_TABLE_SIZE + 4 * BENCH_STACK_SIZE);
+	
+	struct HarbolByteBuf code = harbol_bytebuffer_create();
+	tagha_instr_gen(&code, alloc, 8);
+	tagha_instr_gen(&code, movi, 0, bench_imm(0));
+	tagha_instr_gen(&code, movi, 1, bench_imm(1));
+	tagha_instr_gen(&code, movi, 3, bench_imm(33));
+	tagha_instr_gen(&code, movi, 4, bench_imm(1));
+	tagha_instr_gen(&code, movi, 5, bench_imm(6364136223846793005ULL));
+	tagha_instr_gen(&code, movi, 6, bench_imm(1442695040888963407ULL));
+	tagha_instr_gen(&code, movi, 7, bench_imm(0));
+	tagha_instr_gen(&code, movi, 8, bench_imm(3));
+	
+	const size_t loop = code.count;
+	tagha_instr_gen(&code, mul, 1, 5);
+	tagha_instr_gen(&code, add, 1, 6);
+	tagha_instr_gen(&code, mov, 2, 1);
+	tagha_instr_gen(&code, shr, 2, 3);
+	tagha_instr_gen(&code, bit_and, 2, 10);
+	tagha_instr_gen(&code, shl, 2, 8);
+	tagha_instr_gen(&code, add, 2, 9);
+	tagha_instr_gen(&code, ld8, 2, 2, 0);
+	tagha_instr_gen(&code, add, 0, 2);
+	tagha_instr_gen(&code, sub, 11, 4);
+	tagha_instr_gen(&code, cmp, 11, 7);
+	bench_jz_back(&code, loop);
+	
+	tagha_instr_gen(&code, mov, 8, 0);
+	tagha_instr_gen(&code, redux, 8);
+	tagha_instr_gen(&code, ret);
+	tagha_mod_gen_write_func(&modgen, 0, "walk", &code);
+	harbol_bytebuffer_clear(&code);
+	return tagha_mod_gen_raw(&modgen);
+}
+
+static uint64_t bench_walk_native(const uint64_t table[const], const uint64_t mask, uint64_t iters)
+{
+	uint64_t sum = 0, state = 1;
+	do {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		sum += table[(state >> 33) & mask];
+	} while( --iters != 0 );
+	return sum;
+}
+
+static void bench_run(const char label[const static 1], const uint32_t flags)
+{
+	/// the module owns the buffer it's loaded from.
+	uint8_t *const buffer = bench_make_module();
+	const struct TaghaModuleOpts opts = { .flags = flags };
+	double start = bench_now_ns();
+	struct TaghaModule *module = tagha_module_new_from_buffer_opts(buffer, &opts);
+	const double load_ns = bench_now_ns() - start;
+	if( module==NULL ) {
+		fprintf(stderr, "failed to load module for '%s'.\n", label);
+		return;
+	}
+	
+	const size_t count = BENCH_TABLE_SIZE / sizeof(uint64_t) / 2;
+	start = bench_now_ns();
+	uint64_t *const table = ( uint64_t* )tagha_module_heap_alloc(module, count * sizeof *table);
+	if( table==NULL ) {
+		fprintf(stderr, "failed to allocate table for '%s'.\n", label);
+		tagha_module_free(&module);
+		return;
+	}
+	for( size_t i=0; i<count; i++ )
+		table[i] = i * 2654435761u;
+	const double fill_ns = bench_now_ns() - start;
+	
+	const TaghaFunc walk = tagha_module_get_func(module, "walk");
+	const union TaghaVal params[] = { { .uintptr = ( uintptr_t )table }, { .uint64 = count - 1 }, { .uint64 = BENCH_WALK_ITERS } };
+	union TaghaVal result = { 0 };
+	double best_ns = 0.0;
+	for( size_t run=0; run<BENCH_WALK_RUNS; run++ ) {
+		start = bench_now_ns();
+		tagha_module_invoke(module, walk, 3, params, &result);
+		const double walk_ns = bench_now_ns() - start;
+		if( run==0 || walk_ns < best_ns )
+			best_ns = walk_ns;
+	}
+	
+	const bool matches = result.uint64==bench_walk_native(table, count - 1, BENCH_WALK_ITERS);
+	printf("%-20s | %9.2f | %9.2f | %12.2f | %10.2f%s\n", label, load_ns / 1e6, fill_ns / 1e6, best_ns / BENCH_WALK_ITERS, BENCH_WALK_ITERS / (best_ns / 1e3), matches ? "" : " (result mismatch!)");
+	tagha_module_free(&module);
+}
+
+int main(void)
+{
+	puts("load flags           | load (ms) | fill (ms) | walk (ns/ld) | Mloads/sec");
+	bench_run("none",             0);
+	bench_run("prefault",         TAGHA_LOAD_PREFAULT);
+	bench_run("huge",             TAGHA_LOAD_HUGE_PAGES);
+	bench_run("huge+prefault",    TAGHA_LOAD_HUGE_PAGES | TAGHA_LOAD_PREFAULT);
+	bench_run("huge+prefault+lock", TAGHA_LOAD_HUGE_PAGES | TAGHA_LOAD_PREFAULT | TAGHA_LOAD_MLOCK);
+	return 0;
+}
@@ -0,0 +1,196 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <unistd.h>
+#include "bench_common.h"
+#include "../tagha/loop/loop.h"
+
+/** Event loop benchmark.
+ * 10k scripts each read the same file in chunks through `io_read`,
+ * once called one after another & once all suspended on a loop at the same time.
+ * the sleep runs show the scripts wait concurrently, they'd take minutes one after another.
+ */
+
+enum {
+	BENCH_SCRIPTS     = 10000,
+	BENCH_CHUNK       = 1024,
+	BENCH_FILE_SIZE   = 16 * BENCH_CHUNK,
+	BENCH_SLEEP_MS    = 20,
+	BENCH_STACK_SIZE  = 0x400,
+	BENCH_HEAP_SIZE   = 0x800,
+};
+
+/** uint64_t read_file(int fd, uint8_t *buf, size_t len) {
+ *     uint64_t sum = 0;
+ *     for( size_t off=0; off != len; off += BENCH_CHUNK ) {
+ *         sum += io_read(fd, buf, BENCH_CHUNK, off);
+ *         sum += *( uint64_t* )buf;
+ *     }
+ *     return sum;
+ * }
+ * uint64_t nap(uint64_t ms) {
+ *     io_sleep(ms);
+ *     return 1;
+ * }
+ */
+static uint8_t *bench_make_module(void)
+{
+	struct TaghaModGen modgen = bench_mod_gen(BENCH_STACK_SIZE, BENCH_HEAP_SIZE);
+	
+	struct HarbolByteBuf code = harbol_bytebuffer_create();
+	tagha_mod_gen_write_func(&modgen, TAGHA_FLAG_NATIVE, "io_read", &code);   /// call index 1.
+	tagha_mod_gen_write_func(&modgen, TAGHA_FLAG_NATIVE, "io_sleep", &code);  /// call index 2.
+	
+	tagha_instr_gen(&code, alloc, 9);     /// r9 is the return slot, r10 is 'fd', r11 is 'buf', r12 is 'len'.
+	tagha_instr_gen(&code, movi, 5, bench_imm(0));
+	tagha_instr_gen(&code, movi, 6, bench_imm(0));
+	tagha_instr_gen(&code, movi, 7, bench_imm(BENCH_CHUNK));
+	
+	const size_t loop = code.count;
+	tagha_instr_gen(&code, mov, 1, 10);
+	tagha_instr_gen(&code, mov, 2, 11);
+	tagha_instr_gen(&code, mov, 3, 7);
+	tagha_instr_gen(&code, mov, 4, 6);
+	tagha_instr_gen(&code, call, 1);
+	tagha_instr_gen(&code, add, 5, 0);
+	tagha_instr_gen(&code, ld8, 8, 11, 0);
+	tagha_instr_gen(&code, add, 5, 8);
+	tagha_instr_gen(&code, add, 6, 7);
+	tagha_instr_gen(&code, cmp, 6, 12);
+	bench_jz_back(&code, loop);
+	
+	tagha_instr_gen(&code, mov, 9, 5);
+	tagha_instr_gen(&code, redux, 9);
+	tagha_instr_gen(&code, ret);
+	tagha_mod_gen_write_func(&modgen, 0, "read_file", &code);
+	harbol_bytebuffer_clear(&code);
+	
+	code = harbol_bytebuffer_create();
+	tagha_instr_gen(&code, alloc, 2);     /// r2 is the return slot, r3 is 'ms'.
+	tagha_instr_gen(&code, mov, 1, 3);
+	tagha_instr_gen(&code, call, 2);
+	tagha_instr_gen(&code, movi, 2, bench_imm(1));
+	tagha_instr_gen(&code, redux, 2);
+	tagha_instr_gen(&code, ret);
+	tagha_mod_gen_write_func(&modgen, 0, "nap", &code);
+	harbol_bytebuffer_clear(&code);
+	return tagha_mod_gen_raw(&modgen);
+}
+
+struct BenchScripts {
+	struct TaghaModule *modules[BENCH_SCRIPTS];
+	TaghaFunc read_file[BENCH_SCRIPTS], nap[BENCH_SCRIPTS];
+	uintptr_t bufs[BENCH_SCRIPTS];
+};
+
+static void bench_serial(struct BenchScripts *const scripts, const int fd, const size_t expected)
+{
+	size_t sum = 0;
+	const double start = bench_now_ns();
+	for( size_t i=0; i<BENCH_SCRIPTS; i++ ) {
+		const union TaghaVal params[] = { { .int32 = fd }, { .uintptr = scripts->bufs[i] }, { .size = BENCH_FILE_SIZE } };
+		union TaghaVal result = { 0 };
+		tagha_module_invoke(scripts->modules[i], scripts->read_file[i], 3, params, &result);
+		sum += result.size;
+	}
+	bench_print("read, serial invoke", bench_now_ns() - start, BENCH_SCRIPTS * (BENCH_FILE_SIZE / BENCH_CHUNK), sum==expected);
+}
+
+static void bench_loop_reads(struct BenchScripts *const scripts, const int fd, const uint32_t flags, const size_t expected)
+{
+	struct TaghaLoop loop;
+	if( !tagha_loop_init(&loop, 4096, flags) ) {
+		fputs("failed to start an event loop.\n", stderr);
+		return;
+	}
+	
+	struct BenchTotals totals = { 0 };
+	const double start = bench_now_ns();
+	for( size_t i=0; i<BENCH_SCRIPTS; i++ ) {
+		const union TaghaVal params[] = { { .int32 = fd }, { .uintptr = scripts->bufs[i] }, { .size = BENCH_FILE_SIZE } };
+		tagha_loop_spawn(&loop, scripts->modules[i], scripts->read_file[i], 3, params, &bench_on_done, &totals);
+	}
+	tagha_loop_run(&loop);
+	const double ns = bench_now_ns() - start;
+	
+	char label[64];
+	snprintf(label, sizeof label, "read, loop (%s)", loop.uring ? "io_uring" : "epoll");
+	bench_print(label, ns, BENCH_SCRIPTS * (BENCH_FILE_SIZE / BENCH_CHUNK), totals.sum==expected && totals.count==BENCH_SCRIPTS && totals.errs==0);
+	tagha_loop_clear(&loop);
+}
+
+static void bench_loop_naps(struct BenchScripts *const scripts, const uint32_t flags)
+{
+	struct TaghaLoop loop;
+	if( !tagha_loop_init(&loop, 4096, flags) ) {
+		fputs("failed to start an event loop.\n", stderr);
+		return;
+	}
+	
+	struct BenchTotals totals = { 0 };
+	const double start = bench_now_ns();
+	for( size_t i=0; i<BENCH_SCRIPTS; i++ )
+		tagha_loop_spawn(&loop, scripts->modules[i], scripts->nap[i], 1, &( union TaghaVal ){ .uint64 = BENCH_SLEEP_MS }, &bench_on_done, &totals);
+	tagha_loop_run(&loop);
+	const double ns = bench_now_ns() - start;
+	
+	char label[64];
+	snprintf(label, sizeof label, "%d ms sleep, loop (%s)", BENCH_SLEEP_MS, loop.uring ? "io_uring" : "epoll");
+	bench_print(label, ns, BENCH_SCRIPTS, totals.sum==BENCH_SCRIPTS && totals.errs==0);
+	tagha_loop_clear(&loop);
+}
+
+int main(void)
+{
+	char path[] = "/tmp/tagha_bench_loop_XXXXXX";
+	const int fd = mkstemp(path);
+	if( fd < 0 ) {
+		fputs("failed to create the file to read.\n", stderr);
+		return 1;
+	}
+	unlink(path);
+	
+	/// every chunk starts with its index so the sums show each read landed.
+	static uint8_t data[BENCH_FILE_SIZE];
+	size_t expected = 0;
+	for( uint64_t chunk=0; chunk < BENCH_FILE_SIZE / BENCH_CHUNK; chunk++ ) {
+		memcpy(&data[chunk * BENCH_CHUNK], &chunk, sizeof chunk);
+		expected += BENCH_CHUNK + chunk;
+	}
+	expected *= BENCH_SCRIPTS;
+	if( write(fd, data, sizeof data) != ( ssize_t )sizeof data ) {
+		fputs("failed to write the file to read.\n", stderr);
+		close(fd);
+		return 1;
+	}
+	
+	tagha_native_register_all(tagha_loop_natives);
+	static struct BenchScripts scripts;
+	for( size_t i=0; i<BENCH_SCRIPTS; i++ ) {
+		/// the module owns the buffer it's loaded from.
+		scripts.modules[i] = tagha_module_new_from_buffer(bench_make_module());
+		if( scripts.modules[i]==NULL ) {
+			fprintf(stderr, "failed to load module %zu.\n", i);
+			return 1;
+		}
+		scripts.read_file[i] = tagha_module_get_func(scripts.modules[i], "read_file");
+		scripts.nap[i]       = tagha_module_get_func(scripts.modules[i], "nap");
+		scripts.bufs[i]      = tagha_module_heap_alloc_persistent(scripts.modules[i], BENCH_CHUNK);
+		if( scripts.bufs[i]==NIL ) {
+			fprintf(stderr, "failed to allocate module %zu's buffer.\n", i);
+			return 1;
+		}
+	}
+	
+	puts("run                      | time (ms) | Mops/sec");
+	bench_serial(&scripts, fd, expected);
+	bench_loop_reads(&scripts, fd, 0, expected);
+	bench_loop_reads(&scripts, fd, TAGHA_LOOP_EPOLL, expected);
+	bench_loop_naps(&scripts, 0);
+	bench_loop_naps(&scripts, TAGHA_LOOP_EPOLL);
+	
+	for( size_t i=0; i<BENCH_SCRIPTS; i++ )
+		tagha_module_free(&scripts.modules[i]);
+	tagha_native_registry_clear();
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 199309L
+#include "bench_common.h"
+
+/** Module heap churn benchmark.
+ * keeps 100 to 100k blocks of 16-256 bytes alive in a fragmented heap,
+ * then times freeing a random block & allocating a new one in its place.
+ * Then counts how many small nodes fit in a heap with & without the slab front-end,
+ * and times dynamic arrays that double with realloc.
+ * Then times per-call scratch allocations freed one by one vs an arena released at once.
+ * Last it has several threads churn small blocks in one pool, behind a single lock vs with per-thread magazines.
+ */
+
+enum {
+	BENCH_MAX_LIVE    = 100000,
+	BENCH_CHURN       = 2000000,
+	BENCH_MIN_ALLOC   = 16,
+	BENCH_MAX_ALLOC   = 256,
+	BENCH_NODE_HEAP   = 1 << 20,
+	BENCH_ARRAYS      = 8,
+	BENCH_ARRAY_MAX   = 1 << 16,
+	BENCH_ARRAY_RUNS  = 2000,
+	BENCH_CALLS       = 200000,
+	BENCH_CALL_TEMPS  = 16,
+	BENCH_THREADS     = 8,
+	BENCH_THREAD_LIVE = 1024,
+	BENCH_THREAD_OPS  = 1000000,
+};
+
+/// xorshift so every run churns the same way.
+static uint32_t bench_rand(uint32_t *const state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+static size_t bench_alloc_size(uint32_t *const state)
+{
+	return BENCH_MIN_ALLOC + bench_rand(state) % (BENCH_MAX_ALLOC - BENCH_MIN_ALLOC + 1);
+}
+
+static void bench_node_capacity(void)
+{
+	puts("\n   node | mempool nodes | slab nodes | mempool (ns/alloc) | slab (ns/alloc)");
+	for( size_t node_size=16; node_size<=128; node_size *= 2 ) {
+		struct HarbolMemPool pool = harbol_mempool_create(BENCH_NODE_HEAP);
+		size_t pool_nodes = 0;
+		double start = bench_now_ns();
+		while( harbol_mempool_alloc(&pool, node_size) != NULL )
+			pool_nodes++;
+		const double pool_ns = bench_now_ns() - start;
+		harbol_mempool_clear(&pool);
+		
+		pool = harbol_mempool_create(BENCH_NODE_HEAP);
+		struct HarbolSlabAlloc slabs = harbol_slab_create(&pool);
+		size_t slab_nodes = 0;
+		start = bench_now_ns();
+		while( harbol_slab_alloc(&slabs, node_size) != NULL )
+			slab_nodes++;
+		const double slab_ns = bench_now_ns() - start;
+		harbol_mempool_clear(&pool);
+		
+		printf("%7zu | %13zu | %10zu | %18.1f | %15.1f\n", node_size, pool_nodes, slab_nodes, pool_ns / pool_nodes, slab_ns / slab_nodes);
+	}
+}
+
+/// several arrays growing side by side, like a script building up lists.
+static void bench_array_doubling(void)
+{
+	struct HarbolMemPool pool = harbol_mempool_create(BENCH_ARRAYS * BENCH_ARRAY_MAX * 4);
+	size_t reallocs = 0, in_place = 0;
+	const double start = bench_now_ns();
+	for( size_t run=0; run<BENCH_ARRAY_RUNS; run++ ) {
+		void *arrays[BENCH_ARRAYS] = { NULL };
+		for( size_t size=16; size<=BENCH_ARRAY_MAX; size *= 2 ) {
+			for( size_t i=0; i<BENCH_ARRAYS; i++ ) {
+				void *const resized = harbol_mempool_realloc(&pool, arrays[i], size);
+				in_place += resized==arrays[i];
+				reallocs++;
+				arrays[i] = resized;
+			}
+		}
+		for( size_t i=0; i<BENCH_ARRAYS; i++ )
+			harbol_mempool_free(&pool, arrays[i]);
+	}
+	const double realloc_ns = bench_now_ns() - start;
+	harbol_mempool_clear(&pool);
+	printf("\ndoubling %d arrays to %d bytes: %.1f ns/realloc, %.1f%% in place\n", BENCH_ARRAYS, BENCH_ARRAY_MAX, realloc_ns / reallocs, in_place * 100.0 / reallocs);
+}
+
+/// each "call" allocates a few temporaries that die when it returns.
+static void bench_call_scratch(void)
+{
+	struct HarbolMemPool pool = harbol_mempool_create(BENCH_CALL_TEMPS * (BENCH_MAX_ALLOC + 64) * 2);
+	void *temps[BENCH_CALL_TEMPS];
+	uint32_t state = 0x9E3779B9u;
+	double start = bench_now_ns();
+	for( size_t call=0; call<BENCH_CALLS; call++ ) {
+		for( size_t i=0; i<BENCH_CALL_TEMPS; i++ )
+			temps[i] = harbol_mempool_alloc(&pool, bench_alloc_size(&state));
+		for( size_t i=0; i<BENCH_CALL_TEMPS; i++ )
+			harbol_mempool_free(&pool, temps[i]);
+	}
+	const double pool_ns = bench_now_ns() - start;
+	
+	start = bench_now_ns();
+	for( size_t call=0; call<BENCH_CALLS; call++ ) {
+		const uintptr_t mark = pool.stack.arena;
+		for( size_t i=0; i<BENCH_CALL_TEMPS; i++ )
+			temps[i] = harbol_cache_arena_alloc(&pool.stack, bench_alloc_size(&state));
+		harbol_cache_arena_rewind(&pool.stack, mark);
+	}
+	const double arena_ns = bench_now_ns() - start;
+	harbol_mempool_clear(&pool);
+	printf("\n%d temporaries per call: mempool %.1f ns/call, arena %.1f ns/call\n", BENCH_CALL_TEMPS, pool_ns / BENCH_CALLS, arena_ns / BENCH_CALLS);
+}
+
+struct BenchWorker {
+	struct HarbolMemPool *pool;
+	bool magazines;
+	uint32_t seed;
+};
+
+static void *bench_churn_worker(void *const arg)
+{
+	struct BenchWorker *const worker = arg;
+	void *live[BENCH_THREAD_LIVE] = { NULL };
+	uint32_t state = worker->seed;
+	for( size_t i=0; i<BENCH_THREAD_OPS; i++ ) {
+		const size_t n = bench_rand(&state) % BENCH_THREAD_LIVE;
+		const size_t size = BENCH_MIN_ALLOC + bench_rand(&state) % (128 - BENCH_MIN_ALLOC + 1);
+		if( worker->magazines ) {
+			harbol_mempool_shared_free(worker->pool, live[n]);
+			live[n] = harbol_mempool_shared_alloc(worker->pool, size, false);
+		} else {
+			harbol_mempool_lock(worker->pool);
+			harbol_mempool_free(worker->pool, live[n]);
+			live[n] = harbol_mempool_alloc_uninit(worker->pool, size);
+			harbol_mempool_unlock(worker->pool);
+		}
+	}
+	return NULL;
+}
+
+/// small blocks churned by many threads at once, like natives allocating for scripts running in parallel.
+static void bench_threaded_churn(void)
+{
+	puts("\nthreads | one lock (Mops/sec) | magazines (Mops/sec)");
+	for( size_t threads=1; threads<=BENCH_THREADS; threads *= 2 ) {
+		double mops[2] = { 0.0 };
+		for( size_t mode=0; mode<2; mode++ ) {
+			struct HarbolMemPool pool = harbol_mempool_create(threads * BENCH_THREAD_LIVE * 256 * 2);
+			harbol_mempool_share(&pool);
+			struct HarbolThread handles[BENCH_THREADS];
+			struct BenchWorker workers[BENCH_THREADS];
+			const double start = bench_now_ns();
+			for( size_t i=0; i<threads; i++ ) {
+				workers[i] = (struct BenchWorker){ .pool = &pool, .magazines = mode==1, .seed = 0x9E3779B9u + ( uint32_t )i };
+				harbol_thread_create(&handles[i], &bench_churn_worker, &workers[i]);
+			}
+			for( size_t i=0; i<threads; i++ )
+				harbol_thread_join(&handles[i]);
+			mops[mode] = threads * BENCH_THREAD_OPS / ((bench_now_ns() - start) / 1e3);
+			harbol_mempool_clear(&pool);
+		}
+		printf("%7zu | %19.2f | %20.2f\n", threads, mops[0], mops[1]);
+	}
+}
+
+int main(void)
+{
+	void **const live = malloc(sizeof *live * BENCH_MAX_LIVE);
+	if( live==NULL )
+		return -1;
+	
+	puts("   live | alloc+free (ns/pair) | heap left (bytes)");
+	for( size_t live_count=100; live_count<=BENCH_MAX_LIVE; live_count *= 10 ) {
+		const size_t heapsize = live_count * (BENCH_MAX_ALLOC + 64) * 2;
+		struct HarbolMemPool heap = harbol_mempool_create(heapsize);
+		uint32_t state = 0x9E3779B9u;
+		
+		/// allocate twice as many, then free every other one so the free space is scattered.
+		for( size_t i=0; i<live_count; i++ ) {
+			void *const garbage = harbol_mempool_alloc(&heap, bench_alloc_size(&state));
+			live[i] = harbol_mempool_alloc(&heap, bench_alloc_size(&state));
+			harbol_mempool_free(&heap, garbage);
+		}
+		
+		size_t failed = 0;
+		const double start = bench_now_ns();
+		for( size_t i=0; i<BENCH_CHURN; i++ ) {
+			const size_t n = bench_rand(&state) % live_count;
+			harbol_mempool_free(&heap, live[n]);
+			live[n] = harbol_mempool_alloc(&heap, bench_alloc_size(&state));
+			failed += live[n]==NULL;
+		}
+		const double churn_ns = bench_now_ns() - start;
+		
+		printf("%7zu | %20.1f | %zu", live_count, churn_ns / BENCH_CHURN, harbol_mempool_mem_remaining(&heap));
+		if( failed != 0 )
+			printf(" (%zu failed allocs)", failed);
+		putchar('\n');
+		harbol_mempool_clear(&heap);
+	}
+	free(live);
+	bench_node_capacity();
+	bench_array_doubling();
+	bench_call_scratch();
+	bench_threaded_churn();
+}
@@ -0,0 +1,126 @@
+#define _POSIX_C_SOURCE 199309L
+#include "bench_common.h"
+
+/** parallel_for benchmark.
+ * runs a script loop over the same index range with pools of different sizes,
+ * the calling thread always takes chunks too.
+ */
+
+enum {
+	BENCH_STACK_SIZE  = 0x1000,
+	BENCH_HEAP_SIZE   = 0x10000,
+	BENCH_RANGE       = 1 << 20,
+	BENCH_GRAIN       = 4096,
+	BENCH_ROUNDS      = 64,
+	BENCH_RUNS        = 3,
+};
+
+/** uint64_t g_sum;
+ * void chunk(uint64_t lo, const uint64_t hi) {
+ *     uint64_t sum = 0;
+ *     do {
+ *         uint64_t x = lo;
+ *         for( uint64_t r=BENCH_ROUNDS; r != 0; r-- )
+ *             x = x * 6364136223846793005 + 1442695040888963407, sum += x;
+ *     } while( ++lo != hi );
+ *     atomic_fetch_add(&g_sum, sum);
+ * }
+ */
+static uint8_t *bench_make_module(void)
+{
+	struct TaghaModGen modgen = bench_mod_gen(BENCH_STACK_SIZE, BENCH_HEAP_SIZE);
+	
+	struct HarbolByteBuf code = harbol_bytebuffer_create();
+	tagha_instr_gen(&code, alloc, 8);     /// r9 is 'lo', r10 is 'hi'.
+	tagha_instr_gen(&code, movi, 0, bench_imm(0));
+	tagha_instr_gen(&code, movi, 1, bench_imm(6364136223846793005ULL));
+	tagha_instr_gen(&code, movi, 2, bench_imm(1442695040888963407ULL));
+	tagha_instr_gen(&code, movi, 3, bench_imm(1));
+	tagha_instr_gen(&code, movi, 7, bench_imm(0));
+	
+	const size_t outer = code.count;
+	tagha_instr_gen(&code, mov, 5, 9);
+	tagha_instr_gen(&code, movi, 6, bench_imm(BENCH_ROUNDS));
+	const size_t inner = code.count;
+	tagha_instr_gen(&code, mul, 5, 1);
+	tagha_instr_gen(&code, add, 5, 2);
+	tagha_instr_gen(&code, add, 0, 5);
+	tagha_instr_gen(&code, sub, 6, 3);
+	tagha_instr_gen(&code, cmp, 6, 7);
+	bench_jz_back(&code, inner);
+	tagha_instr_gen(&code, add, 9, 3);
+	tagha_instr_gen(&code, cmp, 9, 10);
+	bench_jz_back(&code, outer);
+	
+	tagha_instr_gen(&code, ldvar, 4, 0);
+	tagha_instr_gen(&code, aadd8, 0, 4, 0);
+	tagha_instr_gen(&code, redux, 8);
+	tagha_instr_gen(&code, ret);
+	tagha_mod_gen_write_func(&modgen, 0, "chunk", &code);
+	harbol_bytebuffer_clear(&code);
+	
+	struct HarbolByteBuf datum = harbol_bytebuffer_create();
+	harbol_bytebuffer_insert_int64(&datum, 0);
+	tagha_mod_gen_write_var(&modgen, 0, "g_sum", &datum);
+	harbol_bytebuffer_clear(&datum);
+	return tagha_mod_gen_raw(&modgen);
+}
+
+static uint64_t bench_sum_native(void)
+{
+	uint64_t sum = 0;
+	for( uint64_t i=0; i<BENCH_RANGE; i++ ) {
+		uint64_t x = i;
+		for( size_t r=0; r<BENCH_ROUNDS; r++ )
+			x = x * 6364136223846793005ULL + 1442695040888963407ULL, sum += x;
+	}
+	return sum;
+}
+
+static void bench_run(struct TaghaModule *const module, const size_t pool_threads, const uint64_t expected)
+{
+	struct HarbolThreadPool pool;
+	if( pool_threads > 0 && !harbol_thread_pool_init(&pool, pool_threads) ) {
+		fprintf(stderr, "failed to start %zu pool threads.\n", pool_threads);
+		return;
+	}
+	tagha_module_set_pool(module, ( pool_threads > 0 ) ? &pool : NULL);
+	
+	const TaghaFunc chunk = tagha_module_get_func(module, "chunk");
+	uint64_t *const g_sum = tagha_module_get_var(module, "g_sum");
+	double best_ns = 0.0;
+	bool matches = true;
+	for( size_t run=0; run<BENCH_RUNS; run++ ) {
+		*g_sum = 0;
+		const double start = bench_now_ns();
+		const bool ok = tagha_module_parallel_for(module, chunk, 0, BENCH_RANGE, BENCH_GRAIN);
+		const double ns = bench_now_ns() - start;
+		matches &= ok && *g_sum==expected;
+		if( run==0 || ns < best_ns )
+			best_ns = ns;
+	}
+	printf("%12zu | %9.2f | %10.2f%s\n", pool_threads + 1, best_ns / 1e6, ( double )BENCH_RANGE * BENCH_ROUNDS / (best_ns / 1e3), matches ? "" : " (result mismatch!)");
+	
+	tagha_module_set_pool(module, NULL);
+	if( pool_threads > 0 )
+		harbol_thread_pool_clear(&pool);
+}
+
+int main(void)
+{
+	/// the module owns the buffer it's loaded from.
+	struct TaghaModule *module = tagha_module_new_from_buffer(bench_make_module());
+	if( module==NULL ) {
+		fputs("failed to load module.\n", stderr);
+		return 1;
+	}
+	
+	const uint64_t expected = bench_sum_native();
+	puts("threads used | best (ms) | Mrounds/sec");
+	bench_run(module, 0, expected);
+	bench_run(module, 1, expected);
+	bench_run(module, 3, expected);
+	bench_run(module, 7, expected);
+	tagha_module_free(&module);
+	return 0;
+}
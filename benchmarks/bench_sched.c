@@ -0,0 +1,147 @@
+#define _POSIX_C_SOURCE 199309L
+#include "bench_common.h"
+
+/** Scheduler benchmark.
+ * queues small calls spread over many modules, once with callbacks & once with futures,
+ * against calling them one after another on a single thread.
+ */
+
+enum {
+	BENCH_MODULES     = 1000,
+	BENCH_TASKS       = 200000,
+	BENCH_ROUNDS      = 256,
+	BENCH_STACK_SIZE  = 0x400,
+	BENCH_HEAP_SIZE   = 0x1000,
+};
+
+/** uint64_t work(uint64_t x) {
+ *     for( uint64_t r=BENCH_ROUNDS; r != 0; r-- )
+ *         x = x * 6364136223846793005 + 1442695040888963407;
+ *     return x;
+ * }
+ */
+static uint8_t *bench_make_module(void)
+{
+	struct TaghaModGen modgen = bench_mod_gen(BENCH_STACK_SIZE, BENCH_HEAP_SIZE);
+	
+	struct HarbolByteBuf code = harbol_bytebuffer_create();
+	tagha_instr_gen(&code, alloc, 5);     /// r5 is the return slot, r6 is 'x'.
+	tagha_instr_gen(&code, movi, 0, bench_imm(6364136223846793005ULL));
+	tagha_instr_gen(&code, movi, 1, bench_imm(1442695040888963407ULL));
+	tagha_instr_gen(&code, movi, 2, bench_imm(1));
+	tagha_instr_gen(&code, movi, 3, bench_imm(BENCH_ROUNDS));
+	tagha_instr_gen(&code, movi, 4, bench_imm(0));
+	
+	const size_t loop = code.count;
+	tagha_instr_gen(&code, mul, 6, 0);
+	tagha_instr_gen(&code, add, 6, 1);
+	tagha_instr_gen(&code, sub, 3, 2);
+	tagha_instr_gen(&code, cmp, 3, 4);
+	bench_jz_back(&code, loop);
+	
+	tagha_instr_gen(&code, mov, 5, 6);
+	tagha_instr_gen(&code, redux, 5);
+	tagha_instr_gen(&code, ret);
+	tagha_mod_gen_write_func(&modgen, 0, "work", &code);
+	harbol_bytebuffer_clear(&code);
+	return tagha_mod_gen_raw(&modgen);
+}
+
+static uint64_t bench_work_native(uint64_t x)
+{
+	for( size_t r=0; r<BENCH_ROUNDS; r++ )
+		x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+	return x;
+}
+
+static void bench_serial(struct TaghaModule *modules[const static BENCH_MODULES], const TaghaFunc funcs[const static BENCH_MODULES], const size_t expected)
+{
+	size_t sum = 0;
+	const double start = bench_now_ns();
+	for( size_t i=0; i<BENCH_TASKS; i++ ) {
+		union TaghaVal result = { 0 };
+		tagha_module_invoke(modules[i % BENCH_MODULES], funcs[i % BENCH_MODULES], 1, &( union TaghaVal ){ .size = i }, &result);
+		sum += result.size;
+	}
+	bench_print("serial invoke", bench_now_ns() - start, BENCH_TASKS, sum==expected);
+}
+
+static void bench_posted(struct TaghaModule *modules[const static BENCH_MODULES], const TaghaFunc funcs[const static BENCH_MODULES], const size_t threads, const size_t expected)
+{
+	struct TaghaSched sched;
+	if( !tagha_sched_init(&sched, threads) ) {
+		fprintf(stderr, "failed to start %zu workers.\n", threads);
+		return;
+	}
+	
+	struct BenchTotals totals = { 0 };
+	const double start = bench_now_ns();
+	for( size_t i=0; i<BENCH_TASKS; i++ )
+		tagha_sched_post(&sched, modules[i % BENCH_MODULES], funcs[i % BENCH_MODULES], 1, &( union TaghaVal ){ .size = i }, &bench_on_done, &totals);
+	tagha_sched_clear(&sched);
+	const double ns = bench_now_ns() - start;
+	
+	char label[64];
+	snprintf(label, sizeof label, "post, %zu workers", threads);
+	bench_print(label, ns, BENCH_TASKS, totals.sum==expected && totals.count==BENCH_TASKS && totals.errs==0);
+}
+
+static void bench_futures(struct TaghaModule *modules[const static BENCH_MODULES], const TaghaFunc funcs[const static BENCH_MODULES], const size_t threads, const size_t expected)
+{
+	struct TaghaSched sched;
+	struct TaghaTask **const tasks = calloc(BENCH_TASKS, sizeof *tasks);
+	if( tasks==NULL || !tagha_sched_init(&sched, threads) ) {
+		fprintf(stderr, "failed to start %zu workers.\n", threads);
+		free(tasks);
+		return;
+	}
+	
+	size_t sum = 0;
+	bool ok = true;
+	const double start = bench_now_ns();
+	for( size_t i=0; i<BENCH_TASKS; i++ )
+		tasks[i] = tagha_sched_submit(&sched, modules[i % BENCH_MODULES], funcs[i % BENCH_MODULES], 1, &( union TaghaVal ){ .size = i });
+	for( size_t i=0; i<BENCH_TASKS; i++ ) {
+		union TaghaVal result = { 0 };
+		ok &= tasks[i] != NULL && tagha_task_wait(tasks[i], &result)==TaghaErrNone;
+		sum += result.size;
+	}
+	const double ns = bench_now_ns() - start;
+	tagha_sched_clear(&sched);
+	free(tasks);
+	
+	char label[64];
+	snprintf(label, sizeof label, "submit+wait, %zu workers", threads);
+	bench_print(label, ns, BENCH_TASKS, ok && sum==expected);
+}
+
+int main(void)
+{
+	static struct TaghaModule *modules[BENCH_MODULES];
+	static TaghaFunc funcs[BENCH_MODULES];
+	for( size_t i=0; i<BENCH_MODULES; i++ ) {
+		/// the module owns the buffer it's loaded from.
+		modules[i] = tagha_module_new_from_buffer(bench_make_module());
+		if( modules[i]==NULL ) {
+			fprintf(stderr, "failed to load module %zu.\n", i);
+			return 1;
+		}
+		funcs[i] = tagha_module_get_func(modules[i], "work");
+	}
+	
+	size_t expected = 0;
+	for( size_t i=0; i<BENCH_TASKS; i++ )
+		expected += bench_work_native(i);
+	
+	puts("run                      | time (ms) | Mtasks/sec");
+	bench_serial(modules, funcs, expected);
+	const size_t workers[] = { 1, 2, 4, 8 };
+	for( size_t i=0; i<sizeof workers / sizeof workers[0]; i++ )
+		bench_posted(modules, funcs, workers[i], expected);
+	for( size_t i=0; i<sizeof workers / sizeof workers[0]; i++ )
+		bench_futures(modules, funcs, workers[i], expected);
+	
+	for( size_t i=0; i<BENCH_MODULES; i++ )
+		tagha_module_free(&modules[i]);
+	return 0;
+}
@@ -0,0 +1,87 @@
+#define _POSIX_C_SOURCE 199309L
+#include "bench_common.h"
+
+/** Symbol table benchmark.
+ * generates modules with 10 to 100k functions,
+ * then times loading them & looking up every function by name.
+ */
+
+enum {
+	BENCH_MAX_SYMS    = 100000,
+	BENCH_LOOKUPS     = 2000000,
+	BENCH_NAME_LEN    = 32,
+};
+
+static void bench_sym_name(char name[const static BENCH_NAME_LEN], const char prefix[const static 1], const size_t i)
+{
+	snprintf(name, BENCH_NAME_LEN, "%s_%zu", prefix, i);
+}
+
+/// bytebuffers grow by exactly what's inserted, reserve upfront so generating 100k funcs isn't quadratic.
+static void bench_reserve(struct HarbolByteBuf *const buf, const size_t bytes)
+{
+	harbol_bytebuffer_insert_zeros(buf, bytes);
+	buf->count = 0;
+}
+
+static uint8_t *bench_make_module(const size_t sym_count)
+{
+	/// item + key + mempool node per symbol, plus the stacks.
+	struct TaghaModGen modgen = bench_mod_gen(0x1000, ( uint32_t )(sym_count * 96 + 0x1000));
+	bench_reserve(&modgen.func_data, sym_count * (sizeof(struct TaghaItemEntry) + BENCH_NAME_LEN + 4));
+	bench_reserve(&modgen.func_hashes, sym_count * sizeof(uint32_t));
+	
+	struct HarbolByteBuf code = harbol_bytebuffer_create();
+	harbol_bytebuffer_insert_byte(&code, ret);
+	
+	char name[BENCH_NAME_LEN];
+	for( size_t i=0; i<sym_count; i++ ) {
+		bench_sym_name(name, "func", i);
+		tagha_mod_gen_write_func(&modgen, 0, name, &code);
+	}
+	harbol_bytebuffer_clear(&code);
+	return tagha_mod_gen_raw(&modgen);
+}
+
+int main(void)
+{
+	char (*const names)[BENCH_NAME_LEN] = malloc(sizeof *names * BENCH_MAX_SYMS);
+	if( names==NULL )
+		return -1;
+	
+	puts("symbols |  load (ms) | hit (ns/lookup) | miss (ns/lookup)");
+	for( size_t sym_count=10; sym_count<=BENCH_MAX_SYMS; sym_count *= 10 ) {
+		uint8_t *const buffer = bench_make_module(sym_count);
+		
+		double start = bench_now_ns();
+		struct TaghaModule *module = tagha_module_new_from_buffer(buffer);
+		const double load_ns = bench_now_ns() - start;
+		if( module==NULL ) {
+			fprintf(stderr, "failed to load module with %zu symbols.\n", sym_count);
+			free(buffer);
+			break;
+		}
+		
+		for( size_t i=0; i<sym_count; i++ )
+			bench_sym_name(names[i], "func", i);
+		
+		size_t found = 0;
+		start = bench_now_ns();
+		for( size_t i=0; i<BENCH_LOOKUPS; i++ )
+			found += tagha_module_get_func(module, names[i % sym_count]) != NULL;
+		const double hit_ns = bench_now_ns() - start;
+		
+		for( size_t i=0; i<sym_count; i++ )
+			bench_sym_name(names[i], "missing", i);
+		
+		start = bench_now_ns();
+		for( size_t i=0; i<BENCH_LOOKUPS; i++ )
+			found += tagha_module_get_func(module, names[i % sym_count]) != NULL;
+		const double miss_ns = bench_now_ns() - start;
+		
+		printf("%7zu | %10.3f | %15.2f | %16.2f%s\n", sym_count, load_ns / 1e6, hit_ns / BENCH_LOOKUPS, miss_ns / BENCH_LOOKUPS, found==BENCH_LOOKUPS ? "" : " (lookup mismatch!)");
+		tagha_module_free(&module);
+	}
+	free(names);
+	return 0;
+}
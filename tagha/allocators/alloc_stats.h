@@ -0,0 +1,60 @@
+#ifndef HARBOL_ALLOC_STATS_INCLUDED
+#	define HARBOL_ALLOC_STATS_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../harbol_common_defines.h"
+#include "../harbol_common_includes.h"
+
+
+enum {
+	HARBOL_STATS_BUCKETS = 32, /// bucket 'i' counts blocks sized [2^i, 2^(i+1)), the last one takes anything bigger.
+};
+
+/// counters kept by the allocators, each update is O(1).
+struct HarbolAllocStats {
+	size_t
+		peak_in_use,
+		allocs[HARBOL_STATS_BUCKETS],
+		frees[HARBOL_STATS_BUCKETS]
+	;
+};
+
+static inline size_t harbol_size_log2(const size_t n)
+{
+#if defined(COMPILER_CLANG) || defined(COMPILER_GCC)
+	return (sizeof(unsigned long long) * CHAR_BIT - 1) - ( size_t )__builtin_clzll(( unsigned long long )n);
+#else
+	size_t i = 0;
+	while( n >> (i + 1) )
+		i++;
+	return i;
+#endif
+}
+
+static inline size_t harbol_stats_bucket(const size_t block_size)
+{
+	const size_t bucket = harbol_size_log2(block_size);
+	return( bucket < HARBOL_STATS_BUCKETS ) ? bucket : HARBOL_STATS_BUCKETS - 1;
+}
+
+static inline NO_NULL void harbol_stats_on_alloc(struct HarbolAllocStats *const stats, const size_t block_size, const size_t in_use)
+{
+	stats->allocs[harbol_stats_bucket(block_size)]++;
+	if( in_use > stats->peak_in_use )
+		stats->peak_in_use = in_use;
+}
+
+static inline NO_NULL void harbol_stats_on_free(struct HarbolAllocStats *const stats, const size_t block_size)
+{
+	stats->frees[harbol_stats_bucket(block_size)]++;
+}
+/********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HARBOL_ALLOC_STATS_INCLUDED */
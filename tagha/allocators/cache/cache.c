@@ -18,6 +18,7 @@ HARBOL_EXPORT struct HarbolCache harbol_cache_create(const size_t size)
 			cache.size = size;
 			cache.mem = ( uintptr_t )buf;
 			cache.offs = cache.mem + size;
+			cache.arena = cache.mem;
 			return cache;
 		}
 	}
@@ -32,6 +33,7 @@ HARBOL_EXPORT struct HarbolCache harbol_cache_from_buffer(void *const restrict b
 		cache.size = size;
 		cache.mem = ( uintptr_t )buf;
 		cache.offs = cache.mem + size;
+		cache.arena = cache.mem;
 		return cache;
 	}
 }
@@ -48,23 +50,110 @@ HARBOL_EXPORT bool harbol_cache_clear(struct HarbolCache *const restrict cache)
 	}
 }
 
-HARBOL_EXPORT void *harbol_cache_alloc(struct HarbolCache *const restrict cache, const size_t size)
+HARBOL_EXPORT void *harbol_cache_alloc_uninit(struct HarbolCache *const restrict cache, const size_t size)
 {
 	if( cache->mem==0 || size==0 || size > cache->size )
 		return NULL;
 	else {
 		const size_t alloc_size = harbol_align_size(size, sizeof(uintptr_t));
-		if( cache->offs - alloc_size < cache->mem )
+		if( cache->offs - cache->arena < alloc_size )
 			return NULL;
 		else {
 			cache->offs -= alloc_size;
-			void *const restrict mem = ( void* )cache->offs;
-			return memset(mem, 0, alloc_size);
+			return ( void* )cache->offs;
 		}
 	}
 }
 
+HARBOL_EXPORT void *harbol_cache_alloc(struct HarbolCache *const restrict cache, const size_t size)
+{
+	void *const restrict mem = harbol_cache_alloc_uninit(cache, size);
+	return( mem==NULL ) ? NULL : memset(mem, 0, harbol_align_size(size, sizeof(uintptr_t)));
+}
+
 HARBOL_EXPORT size_t harbol_cache_remaining(const struct HarbolCache *const cache)
 {
-	return cache->offs - cache->mem;
+	return cache->offs - cache->arena;
+}
+
+
+static inline NO_NULL size_t *_arena_block(const void *const ptr)
+{
+	return ( size_t* )(( uintptr_t )ptr - sizeof(size_t));
+}
+
+HARBOL_EXPORT void *harbol_cache_arena_alloc_uninit(struct HarbolCache *const restrict cache, const size_t size)
+{
+	if( cache->mem==0 || size==0 || size > cache->size )
+		return NULL;
+	else {
+		const size_t alloc_size = harbol_align_size(size, sizeof(uintptr_t)) + sizeof(size_t);
+		if( cache->offs - cache->arena < alloc_size )
+			return NULL;
+		else {
+			size_t *const restrict block = ( size_t* )cache->arena;
+			cache->arena += alloc_size;
+			*block = alloc_size;
+			return block + 1;
+		}
+	}
+}
+
+HARBOL_EXPORT void *harbol_cache_arena_alloc(struct HarbolCache *const restrict cache, const size_t size)
+{
+	void *const restrict mem = harbol_cache_arena_alloc_uninit(cache, size);
+	return( mem==NULL ) ? NULL : memset(mem, 0, *_arena_block(mem) - sizeof(size_t));
+}
+
+HARBOL_EXPORT void *harbol_cache_arena_realloc(struct HarbolCache *const restrict cache, void *const ptr, const size_t size)
+{
+	if( ptr==NULL )
+		return harbol_cache_arena_alloc(cache, size);
+	else if( size==0 || size > cache->size || !harbol_cache_arena_owns(cache, ptr) )
+		return NULL;
+	
+	size_t *const block = _arena_block(ptr);
+	const size_t old_size = *block;
+	const size_t new_size = harbol_align_size(size, sizeof(uintptr_t)) + sizeof(size_t);
+	/// the topmost block can move the arena's end in either direction.
+	if( ( uintptr_t )block + old_size==cache->arena ) {
+		if( new_size > old_size && cache->offs - cache->arena < new_size - old_size )
+			return NULL;
+		cache->arena = ( uintptr_t )block + new_size;
+		*block = new_size;
+		if( new_size > old_size )
+			memset(( uint8_t* )block + old_size, 0, new_size - old_size);
+		return ptr;
+	} else if( new_size <= old_size ) {
+		return ptr;
+	} else {
+		uint8_t *const restrict resized_block = harbol_cache_arena_alloc(cache, size);
+		if( resized_block != NULL )
+			memcpy(resized_block, ptr, old_size - sizeof(size_t));
+		return resized_block;
+	}
+}
+
+HARBOL_EXPORT bool harbol_cache_arena_free(struct HarbolCache *const restrict cache, void *const ptr)
+{
+	if( !harbol_cache_arena_owns(cache, ptr) )
+		return false;
+	else {
+		/// only the topmost block gives its space back, the rest wait for the rewind.
+		size_t *const block = _arena_block(ptr);
+		if( ( uintptr_t )block + *block==cache->arena )
+			cache->arena = ( uintptr_t )block;
+		return true;
+	}
+}
+
+HARBOL_EXPORT bool harbol_cache_arena_owns(const struct HarbolCache *const cache, const void *const ptr)
+{
+	return ( uintptr_t )ptr >= cache->mem + sizeof(size_t) && ( uintptr_t )ptr < cache->arena;
+}
+
+HARBOL_EXPORT void harbol_cache_arena_rewind(struct HarbolCache *const cache, const uintptr_t mark)
+{
+	if( mark >= cache->mem && mark <= cache->arena )
+		cache->arena = mark;
 }
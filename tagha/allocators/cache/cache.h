@@ -9,8 +9,10 @@ extern "C" {
 #include "../../harbol_common_includes.h"
 
 
+/// `harbol_cache_alloc` bumps down from the top while the arena bumps up from `mem`,
+/// [mem, arena) is held by the arena & [offs, mem + size) by the regular allocations.
 struct HarbolCache {
-	uintptr_t mem, offs;
+	uintptr_t mem, offs, arena;
 	size_t size;
 };
 
@@ -19,7 +21,18 @@ HARBOL_EXPORT NO_NULL struct HarbolCache harbol_cache_from_buffer(void *buf, siz
 HARBOL_EXPORT NO_NULL bool harbol_cache_clear(struct HarbolCache *cache);
 
 HARBOL_EXPORT NO_NULL void *harbol_cache_alloc(struct HarbolCache *cache, size_t bytes);
+/// `_uninit` allocators leave the memory as they found it.
+HARBOL_EXPORT NO_NULL void *harbol_cache_alloc_uninit(struct HarbolCache *cache, size_t bytes);
 HARBOL_EXPORT NO_NULL size_t harbol_cache_remaining(const struct HarbolCache *cache);
+
+/// arena blocks carry their size so the topmost one can be resized or popped in place,
+/// all others are only released by rewinding the arena to a mark taken earlier from `arena`.
+HARBOL_EXPORT NO_NULL void *harbol_cache_arena_alloc(struct HarbolCache *cache, size_t bytes);
+HARBOL_EXPORT NO_NULL void *harbol_cache_arena_alloc_uninit(struct HarbolCache *cache, size_t bytes);
+HARBOL_EXPORT NEVER_NULL(1) void *harbol_cache_arena_realloc(struct HarbolCache *cache, void *ptr, size_t bytes);
+HARBOL_EXPORT NO_NULL bool harbol_cache_arena_free(struct HarbolCache *cache, void *ptr);
+HARBOL_EXPORT NO_NULL bool harbol_cache_arena_owns(const struct HarbolCache *cache, const void *ptr);
+HARBOL_EXPORT NO_NULL void harbol_cache_arena_rewind(struct HarbolCache *cache, uintptr_t mark);
 /********************************************************************/
 
 
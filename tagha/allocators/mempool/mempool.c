@@ -5,140 +5,94 @@
 #endif
 
 
-HARBOL_EXPORT struct HarbolMemNode *harbol_memnode_split(struct HarbolMemNode *const node, const size_t bytes)
+static inline size_t _harbol_lowest_bit(const size_t n)
 {
-	uintptr_t n = ( uintptr_t )node;
-	struct HarbolMemNode *r = ( struct HarbolMemNode* )(n + (node->size - bytes));
-	node->size -= bytes;
-	r->size = bytes;
-	return r;
+#if defined(COMPILER_CLANG) || defined(COMPILER_GCC)
+	return ( size_t )__builtin_ctzll(( unsigned long long )n);
+#else
+	size_t i = 0;
+	while( !(n & (( size_t )1 << i)) )
+		i++;
+	return i;
+#endif
 }
 
-
-HARBOL_EXPORT void harbol_memnode_replace(struct HarbolMemNode *const old, struct HarbolMemNode *const replace)
+static inline size_t _memnode_size(const struct HarbolMemNode *const node)
 {
-	/// replace this node.
-	replace->prev = old->prev;
-	replace->next = old->next;
-	if( replace->prev != NULL )
-		replace->prev->next = replace;
-	if( replace->next != NULL )
-		replace->next->prev = replace;
+	return node->size & ~( size_t )HARBOL_MEMNODE_FLAGS;
 }
 
-
-/// makes a current node into the next node.
-HARBOL_EXPORT void harbol_freelist_insert_before(struct HarbolFreeList *const list, struct HarbolMemNode *const curr, struct HarbolMemNode *const insert)
+static inline struct HarbolMemNode *_memnode_from_ptr(void *const ptr)
 {
-	insert->next = curr;
-	if (curr->prev==NULL) list->head = insert;
-	else {
-		insert->prev = curr->prev;
-		curr->prev->next = insert;
-	}
-    curr->prev = insert;
+	return ( struct HarbolMemNode* )(( uint8_t* )ptr - HARBOL_MEMNODE_HDR);
 }
 
+/// returns the next block up, `top` if 'node' is the highest block.
+static inline NO_NULL struct HarbolMemNode *_memnode_above(struct HarbolMemPool *const mempool, struct HarbolMemNode *const node, const size_t size)
+{
+	const uintptr_t above = ( uintptr_t )node + size;
+	return( above < mempool->stack.mem + mempool->stack.size ) ? ( struct HarbolMemNode* )above : &mempool->top;
+}
 
-HARBOL_EXPORT void harbol_freelist_insert(struct HarbolMemPool *const mempool, struct HarbolFreeList *const list, struct HarbolMemNode *const node, const bool is_bucket)
+static NO_NULL void _bin_insert(struct HarbolMemPool *const mempool, struct HarbolMemNode *const node, const size_t size)
 {
-	if( list->head==NULL ) {
-		list->head = node;
-		list->len++;
-	} else {
-		for( struct HarbolMemNode *iter = list->head; iter != NULL; iter = iter->next ) {
-			if( ( uintptr_t )iter == mempool->stack.offs ) {
-				mempool->stack.offs += iter->size;
-				harbol_freelist_remove(list, iter);
-				iter = list->head;
-			}
-			const uintptr_t inode = ( uintptr_t )node;
-			const uintptr_t iiter = ( uintptr_t )iter;
-			const uintptr_t iter_end = iiter + iter->size;
-			const uintptr_t node_end = inode + node->size;
-			
-			if( iter==node )
-				return;
-			else if( iter < node ) {
-				if( iter_end > inode ) // node was coalesced prior.
-					return;
-				else if( iter_end==inode ) { // if we can coalesce, do so.
-					iter->size += node->size;
-					if( is_bucket )
-						harbol_freelist_insert(mempool, &mempool->large, harbol_freelist_remove(list, iter), false);
-					return;
-				}
-			} else if( iter > node ) {
-				// Address sort, lowest to highest aka ascending order.
-				if( iter==list->head ) {
-					if( iter_end==inode ) {
-						iter->size += node->size;
-						if( is_bucket )
-							harbol_freelist_insert(mempool, &mempool->large, harbol_freelist_remove(list, iter), false);
-					} else if( node_end==iiter ) {
-						node->size += list->head->size;
-						node->next = list->head->next;
-						node->prev = NULL;
-						list->head = node;
-						if( is_bucket )
-							harbol_freelist_insert(mempool, &mempool->large, harbol_freelist_remove(list, list->head), false);
-					} else {
-						node->next = iter;
-						node->prev = NULL;
-						iter->prev = node;
-						list->head = node;
-						list->len++;
-					}
-					return;
-				} else if( iter_end==inode ) {
-					iter->size += node->size;
-					if( is_bucket )
-						harbol_freelist_insert(mempool, &mempool->large, harbol_freelist_remove(list, iter), false);
-					return;
-				} else {
-					harbol_freelist_insert_before(list, iter, node);
-					list->len++;
-					return;
-				}
-			}
-		}
-	}
+	const size_t bin = harbol_size_log2(size);
+	node->size = size | HARBOL_MEMNODE_FREE;
+	*( size_t* )(( uintptr_t )node + size - sizeof(size_t)) = size;
+	node->prev = NULL;
+	node->next = mempool->bins[bin];
+	if( node->next != NULL )
+		node->next->prev = node;
+	mempool->bins[bin] = node;
+	mempool->bitmap |= ( size_t )1 << bin;
+	mempool->free_bytes += size;
 }
 
-HARBOL_EXPORT struct HarbolMemNode *harbol_freelist_remove(struct HarbolFreeList *const list, struct HarbolMemNode *const node)
+static NO_NULL void _bin_remove(struct HarbolMemPool *const mempool, struct HarbolMemNode *const node)
 {
+	const size_t size = _memnode_size(node);
+	const size_t bin = harbol_size_log2(size);
 	if( node->prev != NULL )
 		node->prev->next = node->next;
 	else {
-		list->head = node->next;
-		if( list->head != NULL )
-			list->head->prev = NULL;
-		else list->tail = NULL;
+		mempool->bins[bin] = node->next;
+		if( node->next==NULL )
+			mempool->bitmap &= ~(( size_t )1 << bin);
 	}
-	
 	if( node->next != NULL )
 		node->next->prev = node->prev;
-	else {
-		list->tail = node->prev;
-		if( list->tail != NULL )
-			list->tail->next = NULL;
-		else list->head = NULL;
+	node->size &= ~( size_t )HARBOL_MEMNODE_FREE;
+	mempool->free_bytes -= size;
+}
+
+/// O(1): the head of the size's own bin gets one look, any block of a higher bin always fits.
+static NO_NULL struct HarbolMemNode *_get_freenode(struct HarbolMemPool *const mempool, const size_t bytes)
+{
+	const size_t bin = harbol_size_log2(bytes);
+	struct HarbolMemNode *node = mempool->bins[bin];
+	if( node==NULL || _memnode_size(node) < bytes ) {
+		const size_t higher = ( bin + 1 < HARBOL_BIN_COUNT ) ? mempool->bitmap & (~( size_t )0 << (bin + 1)) : 0;
+		if( higher==0 )
+			return NULL;
+		node = mempool->bins[_harbol_lowest_bit(higher)];
 	}
-	list->len--;
+	
+	_bin_remove(mempool, node);
+	const size_t size = _memnode_size(node);
+	if( size - bytes >= HARBOL_MEMNODE_MIN ) {
+		/// the lower part stays free, hand out the upper part.
+		_bin_insert(mempool, node, size - bytes);
+		node = ( struct HarbolMemNode* )(( uintptr_t )node + size - bytes);
+		node->size = bytes | HARBOL_MEMNODE_PREV_FREE;
+	}
+	_memnode_above(mempool, node, _memnode_size(node))->size &= ~( size_t )HARBOL_MEMNODE_PREV_FREE;
 	return node;
 }
 
-HARBOL_EXPORT struct HarbolMemNode *harbol_freelist_find(struct HarbolFreeList *const list, const size_t bytes)
+static inline size_t _memnode_alloc_size(const size_t bytes)
 {
-	for( struct HarbolMemNode *node = list->head; node != NULL; node = node->next ) {
-		if( node->size < bytes )
-			continue;
-		// close in size - reduce fragmentation by not splitting.
-		else if( node->size <= bytes + MEM_SPLIT_THRESHOLD )
-			return harbol_freelist_remove(list, node);
-		else return harbol_memnode_split(node, bytes);
-	}
-	return NULL;
+	const size_t alloc_bytes = harbol_align_size(bytes + HARBOL_MEMNODE_HDR, sizeof(intptr_t));
+	return( alloc_bytes < HARBOL_MEMNODE_MIN ) ? HARBOL_MEMNODE_MIN : alloc_bytes;
 }
 
 
@@ -166,20 +120,35 @@ HARBOL_EXPORT struct HarbolMemPool harbol_mempool_from_buffer(void *const restri
 
 HARBOL_EXPORT bool harbol_mempool_clear(struct HarbolMemPool *const mempool)
 {
+	harbol_mempool_unshare(mempool);
 	bool result = harbol_cache_clear(&mempool->stack);
 	*mempool = (struct HarbolMemPool){ 0 };
 	return result;
 }
 
-static NO_NULL struct HarbolMemNode *_get_freenode(struct HarbolMemPool *const mempool, const size_t bytes)
+/// large blocks on page backed pools only memset their partial pages.
+static NO_NULL void *_mempool_zero(const struct HarbolMemPool *const mempool, void *const ptr, const size_t bytes)
 {
-	// check if we have a good sized node from the buckets.
-	const uindex_t slot = (bytes >> HARBOL_BUCKET_BITS) - 1;
-	struct HarbolFreeList *const l = (slot < HARBOL_BUCKET_SIZE) ? &mempool->buckets[slot] : &mempool->large;
-	return harbol_freelist_find(l, bytes);
+	if( mempool->page_zero_min != 0 && bytes >= mempool->page_zero_min ) {
+		const size_t page = harbol_vmem_page_size();
+		const uintptr_t start = harbol_align_size(( uintptr_t )ptr, page);
+		const uintptr_t end = (( uintptr_t )ptr + bytes) & -( uintptr_t )page;
+		if( end > start && harbol_vmem_zero(( void* )start, end - start) ) {
+			memset(ptr, 0, start - ( uintptr_t )ptr);
+			memset(( void* )end, 0, ( uintptr_t )ptr + bytes - end);
+			return ptr;
+		}
+	}
+	return memset(ptr, 0, bytes);
 }
 
 HARBOL_EXPORT void *harbol_mempool_alloc(struct HarbolMemPool *const mempool, const size_t size)
+{
+	uint8_t *const mem = harbol_mempool_alloc_uninit(mempool, size);
+	return( mem==NULL ) ? NULL : _mempool_zero(mempool, mem, _memnode_size(_memnode_from_ptr(mem)) - HARBOL_MEMNODE_HDR);
+}
+
+HARBOL_EXPORT void *harbol_mempool_alloc_uninit(struct HarbolMemPool *const mempool, const size_t size)
 {
 	if( size==0 || size > mempool->stack.size )
 		return NULL;
@@ -187,29 +156,41 @@ HARBOL_EXPORT void *harbol_mempool_alloc(struct HarbolMemPool *const mempool, co
 		// visual of the allocation block.
 		// --------------
 		// |  mem size  | lowest addr of block
-		// |  next node | 12 bytes - 32 bit
-		// |  prev node | 24 bytes - 64 bit
-		// |------------|
-		// |   alloc'd  |
+		// |------------| 4 bytes - 32 bit
+		// |   alloc'd  | 8 bytes - 64 bit
 		// |   memory   |
 		// |   space    | highest addr of block
 		// --------------
-		const size_t alloc_bytes = harbol_align_size(size + sizeof(struct HarbolMemNode), sizeof(intptr_t));
+		const size_t alloc_bytes = _memnode_alloc_size(size);
 		struct HarbolMemNode *new_mem = _get_freenode(mempool, alloc_bytes);
 		
 		if( new_mem==NULL ) {
-			new_mem = harbol_cache_alloc(&mempool->stack, alloc_bytes);
+			new_mem = harbol_cache_alloc_uninit(&mempool->stack, alloc_bytes);
 			if( new_mem==NULL )
 				return NULL;
 			else new_mem->size = alloc_bytes;
 		}
 		
-		new_mem->next = new_mem->prev = NULL;
-		uint8_t *const final_mem = ( uint8_t* )new_mem + sizeof *new_mem;
-		return memset(final_mem, 0, new_mem->size - sizeof *new_mem);
+		harbol_stats_on_alloc(&mempool->stats, _memnode_size(new_mem), harbol_mempool_mem_in_use(mempool));
+		return ( uint8_t* )new_mem + HARBOL_MEMNODE_HDR;
 	}
 }
 
+static NO_NULL void _mempool_release(struct HarbolMemPool *mempool, struct HarbolMemNode *mem_node);
+
+/// gives the tail past 'keep' bytes back to the pool if it's big enough to be a block.
+static NO_NULL void _memnode_trim(struct HarbolMemPool *const mempool, struct HarbolMemNode *const node, const size_t keep)
+{
+	const size_t size = _memnode_size(node);
+	if( size - keep < HARBOL_MEMNODE_MIN )
+		return;
+	
+	node->size = keep | (node->size & HARBOL_MEMNODE_PREV_FREE);
+	struct HarbolMemNode *const tail = ( struct HarbolMemNode* )(( uintptr_t )node + keep);
+	tail->size = size - keep;
+	_mempool_release(mempool, tail);
+}
+
 HARBOL_EXPORT void *harbol_mempool_realloc(struct HarbolMemPool *const restrict mempool, void *const ptr, const size_t size)
 {
 	if( size > mempool->stack.size )
@@ -217,46 +198,123 @@ HARBOL_EXPORT void *harbol_mempool_realloc(struct HarbolMemPool *const restrict
 	// NULL ptr should make this work like regular alloc.
 	else if( ptr==NULL )
 		return harbol_mempool_alloc(mempool, size);
-	else if( ( uintptr_t )ptr - sizeof(struct HarbolMemNode) < mempool->stack.mem )
+	else if( size==0 || ( uintptr_t )ptr - HARBOL_MEMNODE_HDR < mempool->stack.offs || ( uintptr_t )ptr >= mempool->stack.mem + mempool->stack.size )
 		return NULL;
-	else {
-		struct HarbolMemNode *node = ( struct HarbolMemNode* )(( uint8_t* )ptr - sizeof *node);
-		uint8_t *resized_block = harbol_mempool_alloc(mempool, size);
-		if( resized_block==NULL )
-			return NULL;
-		else {
-			struct HarbolMemNode *resized = ( struct HarbolMemNode* )(resized_block - sizeof *resized);
-			memmove(resized_block, ptr, ((node->size > resized->size)? (resized->size) : (node->size)) - sizeof *node);
-			harbol_mempool_free(mempool, ptr);
-			return resized_block;
+	
+	struct HarbolMemNode *node = _memnode_from_ptr(ptr);
+	const size_t old_size = _memnode_size(node);
+	const size_t new_size = _memnode_alloc_size(size);
+	if( node->size & HARBOL_MEMNODE_FREE )
+		return NULL;
+	
+	// a resize counts as freeing the old block & allocating the new one.
+	// shrink in place.
+	if( new_size <= old_size ) {
+		_memnode_trim(mempool, node, new_size);
+		harbol_stats_on_free(&mempool->stats, old_size);
+		harbol_stats_on_alloc(&mempool->stats, _memnode_size(node), harbol_mempool_mem_in_use(mempool));
+		return ptr;
+	}
+	
+	// grow in place into the free block above.
+	struct HarbolMemNode *const above = _memnode_above(mempool, node, old_size);
+	if( (above->size & HARBOL_MEMNODE_FREE) && old_size + _memnode_size(above) >= new_size ) {
+		_bin_remove(mempool, above);
+		node->size += _memnode_size(above);
+		_memnode_above(mempool, node, _memnode_size(node))->size &= ~( size_t )HARBOL_MEMNODE_PREV_FREE;
+		_memnode_trim(mempool, node, new_size);
+		harbol_stats_on_free(&mempool->stats, old_size);
+		harbol_stats_on_alloc(&mempool->stats, _memnode_size(node), harbol_mempool_mem_in_use(mempool));
+		_mempool_zero(mempool, ( uint8_t* )ptr + old_size - HARBOL_MEMNODE_HDR, _memnode_size(node) - old_size);
+		return ptr;
+	}
+	
+	// grow down into the bump region or the free block below.
+	// the data has to move but nothing is allocated or freed.
+	struct HarbolMemNode *start = NULL;
+	if( ( uintptr_t )node==mempool->stack.offs ) {
+		const size_t delta = new_size - old_size;
+		if( harbol_cache_remaining(&mempool->stack) >= delta ) {
+			mempool->stack.offs -= delta;
+			start = ( struct HarbolMemNode* )mempool->stack.offs;
+			start->size = new_size;
 		}
+	} else if( node->size & HARBOL_MEMNODE_PREV_FREE ) {
+		const size_t below_size = *( const size_t* )(( uintptr_t )node - sizeof(size_t));
+		if( below_size + old_size >= new_size ) {
+			start = ( struct HarbolMemNode* )(( uintptr_t )node - below_size);
+			_bin_remove(mempool, start);
+			start->size = below_size + old_size;
+		}
+	}
+	if( start != NULL ) {
+		uint8_t *const data = ( uint8_t* )start + HARBOL_MEMNODE_HDR;
+		memmove(data, ptr, old_size - HARBOL_MEMNODE_HDR);
+		_memnode_trim(mempool, start, new_size);
+		harbol_stats_on_free(&mempool->stats, old_size);
+		harbol_stats_on_alloc(&mempool->stats, _memnode_size(start), harbol_mempool_mem_in_use(mempool));
+		_mempool_zero(mempool, data + old_size - HARBOL_MEMNODE_HDR, _memnode_size(start) - old_size);
+		return data;
+	}
+	
+	uint8_t *const resized_block = harbol_mempool_alloc(mempool, size);
+	if( resized_block==NULL )
+		return NULL;
+	else {
+		memcpy(resized_block, ptr, old_size - HARBOL_MEMNODE_HDR);
+		harbol_mempool_free(mempool, ptr);
+		return resized_block;
+	}
+}
+
+/// coalesces a block with its free neighbors & puts it back in a bin or the cache.
+static NO_NULL void _mempool_release(struct HarbolMemPool *const mempool, struct HarbolMemNode *mem_node)
+{
+	size_t size = _memnode_size(mem_node);
+	// coalesce with the free neighbors, there's never more than one on either side.
+	struct HarbolMemNode *const above = _memnode_above(mempool, mem_node, size);
+	if( above->size & HARBOL_MEMNODE_FREE ) {
+		_bin_remove(mempool, above);
+		size += _memnode_size(above);
+	}
+	if( mem_node->size & HARBOL_MEMNODE_PREV_FREE ) {
+		const size_t below_size = *( const size_t* )(( uintptr_t )mem_node - sizeof(size_t));
+		struct HarbolMemNode *const below = ( struct HarbolMemNode* )(( uintptr_t )mem_node - below_size);
+		_bin_remove(mempool, below);
+		size += below_size;
+		mem_node = below;
+	}
+	
+	struct HarbolMemNode *const next = _memnode_above(mempool, mem_node, size);
+	// if the mem_node is right at the stack base ptr, then add it to the stack.
+	if( ( uintptr_t )mem_node==mempool->stack.offs ) {
+		mempool->stack.offs += size;
+		next->size &= ~( size_t )HARBOL_MEMNODE_PREV_FREE;
+	} else {
+		_bin_insert(mempool, mem_node, size);
+		next->size |= HARBOL_MEMNODE_PREV_FREE;
 	}
 }
 
 HARBOL_EXPORT bool harbol_mempool_free(struct HarbolMemPool *const restrict mempool, void *const ptr)
 {
-	if( ptr==NULL || ( uintptr_t )ptr - sizeof(struct HarbolMemNode) < mempool->stack.mem )
+	if( ptr==NULL || ( uintptr_t )ptr - HARBOL_MEMNODE_HDR < mempool->stack.mem )
 		return false;
 	else {
 		// behind the actual pointer data is the allocation info.
-		struct HarbolMemNode *mem_node = (struct HarbolMemNode *)((uint8_t *)ptr - sizeof *mem_node);
-		const uindex_t slot = (mem_node->size >> HARBOL_BUCKET_BITS) - 1;
+		struct HarbolMemNode *const mem_node = _memnode_from_ptr(ptr);
+		const size_t size = _memnode_size(mem_node);
 		
 		// make sure the pointer data is valid.
-		if( (uintptr_t)mem_node < mempool->stack.offs
-				|| ((uintptr_t)mem_node - mempool->stack.mem) > mempool->stack.size
-				|| mem_node->size==0
-				|| mem_node->size > mempool->stack.size )
+		if( ( uintptr_t )mem_node < mempool->stack.offs
+				|| (( uintptr_t )mem_node - mempool->stack.mem) > mempool->stack.size
+				|| (mem_node->size & HARBOL_MEMNODE_FREE)
+				|| size < HARBOL_MEMNODE_MIN
+				|| size > mempool->stack.mem + mempool->stack.size - ( uintptr_t )mem_node )
 			return false;
 		
-		// if the mem_node is right at the stack base ptr, then add it to the stack.
-		else if( (uintptr_t)mem_node==mempool->stack.offs )
-			mempool->stack.offs += mem_node->size;
-		else {
-			// try to place it into bucket or large freelist.
-			struct HarbolFreeList *const list = ( slot < HARBOL_BUCKET_SIZE ) ? &mempool->buckets[slot] : &mempool->large;
-			harbol_freelist_insert(mempool, list, mem_node, ( slot < HARBOL_BUCKET_SIZE ));
-		}
+		harbol_stats_on_free(&mempool->stats, size);
+		_mempool_release(mempool, mem_node);
 		return true;
 	}
 }
@@ -272,16 +330,254 @@ HARBOL_EXPORT bool harbol_mempool_cleanup(struct HarbolMemPool *const restrict m
 	}
 }
 
-HARBOL_EXPORT size_t harbol_mempool_mem_remaining(const struct HarbolMemPool *mempool)
+HARBOL_EXPORT bool harbol_mempool_grow(struct HarbolMemPool *const mempool, const size_t bytes)
 {
-	size_t total_remaining = mempool->stack.offs - mempool->stack.mem;
+	if( mempool->stack.mem==0 || bytes < HARBOL_MEMNODE_MIN || bytes % sizeof(uintptr_t) != 0 )
+		return false;
+	else {
+		/// the new memory is freed like a block, merging with the highest block if that's free.
+		struct HarbolMemNode *const node = ( struct HarbolMemNode* )(mempool->stack.mem + mempool->stack.size);
+		node->size = bytes | (mempool->top.size & HARBOL_MEMNODE_PREV_FREE);
+		mempool->top.size = 0;
+		mempool->stack.size += bytes;
+		_mempool_release(mempool, node);
+		return true;
+	}
+}
+
+/// takes up to 'bytes' off the end of the pool if the highest block is free, returns how many bytes it shrank by.
+HARBOL_EXPORT size_t harbol_mempool_shrink(struct HarbolMemPool *const mempool, const size_t bytes)
+{
+	const uintptr_t end = mempool->stack.mem + mempool->stack.size;
+	size_t cut = bytes & -sizeof(uintptr_t);
+	if( mempool->stack.offs==end ) {
+		/// nothing allocated from the cache, the bump space reaches the end.
+		if( cut > harbol_cache_remaining(&mempool->stack) )
+			cut = harbol_cache_remaining(&mempool->stack) & -sizeof(uintptr_t);
+		mempool->stack.offs -= cut;
+		mempool->stack.size -= cut;
+		return cut;
+	} else if( !(mempool->top.size & HARBOL_MEMNODE_PREV_FREE) ) {
+		return 0;
+	}
 	
-	for( struct HarbolMemNode *n = mempool->large.head; n != NULL; n = n->next )
-		total_remaining += n->size;
+	const size_t top_size = *( const size_t* )(end - sizeof(size_t));
+	struct HarbolMemNode *const node = ( struct HarbolMemNode* )(end - top_size);
+	if( cut >= top_size )
+		cut = top_size;
+	else if( top_size - cut < HARBOL_MEMNODE_MIN ) {
+		if( top_size < HARBOL_MEMNODE_MIN * 2 )
+			return 0;
+		cut = top_size - HARBOL_MEMNODE_MIN;
+	}
 	
-	for( uindex_t i=0; i<HARBOL_BUCKET_SIZE; i++ )
-		for( struct HarbolMemNode *n=mempool->buckets[i].head; n != NULL; n = n->next )
-			total_remaining += n->size;
+	_bin_remove(mempool, node);
+	mempool->stack.size -= cut;
+	if( cut < top_size ) {
+		_bin_insert(mempool, node, top_size - cut);
+		mempool->top.size = HARBOL_MEMNODE_PREV_FREE;
+	} else {
+		/// free blocks are always merged, the one below was in use.
+		mempool->top.size = 0;
+	}
+	return cut;
+}
+
+HARBOL_EXPORT bool harbol_mempool_rewind(struct HarbolMemPool *const mempool, const uintptr_t mark, const size_t size)
+{
+	if( mempool->stack.mem==0 || size > mempool->stack.size || mark < mempool->stack.arena || mark > mempool->stack.mem + size )
+		return false;
+	
+	/// free blocks only live below 'mark' or past 'size', emptying the bins is enough to drop them.
+	const size_t grown = mempool->stack.size - size;
+	memset(mempool->bins, 0, sizeof mempool->bins);
+	mempool->bitmap     = 0;
+	mempool->free_bytes = 0;
+	mempool->stack.offs = mark;
+	mempool->stack.size = size;
+	mempool->top.size   = 0;
+	if( mark < mempool->stack.mem + size )
+		(( struct HarbolMemNode* )mark)->size &= ~( size_t )HARBOL_MEMNODE_PREV_FREE;
+	
+	/// cached blocks went with everything else.
+	if( mempool->shared != NULL ) {
+		for( size_t i=0; i<HARBOL_MAG_THREADS; i++ )
+			if( mempool->shared->mags[i] != NULL )
+				memset(mempool->shared->mags[i], 0, HARBOL_MAG_CLASSES * sizeof *mempool->shared->mags[i]);
+	}
+	
+	/// memory past 'size' comes back as one free block.
+	return( grown==0 ) ? true : harbol_mempool_grow(mempool, grown);
+}
+
+HARBOL_EXPORT bool harbol_mempool_share(struct HarbolMemPool *const mempool)
+{
+	if( mempool->shared != NULL )
+		return true;
+	
+	struct HarbolMemPoolShared *const shared = calloc(1, sizeof *shared);
+	if( shared==NULL )
+		return false;
+	else if( !harbol_mutex_init(&shared->lock) ) {
+		free(shared);
+		return false;
+	}
+	mempool->shared = shared;
+	return true;
+}
+
+HARBOL_EXPORT void harbol_mempool_unshare(struct HarbolMemPool *const mempool)
+{
+	if( mempool->shared==NULL )
+		return;
+	
+	harbol_mempool_shared_drain(mempool);
+	for( size_t i=0; i<HARBOL_MAG_THREADS; i++ )
+		free(mempool->shared->mags[i]);
+	harbol_mutex_destroy(&mempool->shared->lock);
+	free(mempool->shared);
+	mempool->shared = NULL;
+}
+
+HARBOL_EXPORT void harbol_mempool_lock(const struct HarbolMemPool *const mempool)
+{
+	if( mempool->shared != NULL )
+		harbol_mutex_lock(&mempool->shared->lock);
+}
+
+HARBOL_EXPORT void harbol_mempool_unlock(const struct HarbolMemPool *const mempool)
+{
+	if( mempool->shared != NULL )
+		harbol_mutex_unlock(&mempool->shared->lock);
+}
+
+/// the calling thread's magazines, NULL if it has none & can't get any.
+static NO_NULL struct HarbolMagazine *_mempool_magazines(struct HarbolMemPoolShared *const shared)
+{
+	/// an exited thread's slot & the blocks its magazines still cache go to the next thread that takes the slot.
+	const size_t slot = harbol_thread_slot();
+	if( slot >= HARBOL_MAG_THREADS )
+		return NULL;
+	else if( shared->mags[slot]==NULL )
+		/// only the owning thread ever touches its slot.
+		shared->mags[slot] = calloc(HARBOL_MAG_CLASSES, sizeof *shared->mags[slot]);
+	return shared->mags[slot];
+}
+
+static inline size_t _mag_block_size(const size_t class)
+{
+	return (class + 2) * 16;
+}
+
+HARBOL_EXPORT void *harbol_mempool_shared_alloc(struct HarbolMemPool *const mempool, const size_t size, const bool zero)
+{
+	struct HarbolMemPoolShared *const shared = mempool->shared;
+	const size_t alloc_bytes = _memnode_alloc_size(size);
+	struct HarbolMagazine *const mags = ( shared==NULL || size==0 || alloc_bytes > _mag_block_size(HARBOL_MAG_CLASSES - 1) ) ? NULL : _mempool_magazines(shared);
+	if( mags==NULL ) {
+		harbol_mempool_lock(mempool);
+		void *const p = zero ? harbol_mempool_alloc(mempool, size) : harbol_mempool_alloc_uninit(mempool, size);
+		harbol_mempool_unlock(mempool);
+		return p;
+	}
+	
+	/// every block of a class is at least that class' size so any of them can serve the request.
+	const size_t class = (alloc_bytes + 15) / 16 - 2;
+	struct HarbolMagazine *const mag = &mags[class];
+	if( mag->count==0 ) {
+		harbol_mutex_lock(&shared->lock);
+		while( mag->count < HARBOL_MAG_ROUNDS / 2 ) {
+			void *const p = harbol_mempool_alloc_uninit(mempool, _mag_block_size(class) - HARBOL_MEMNODE_HDR);
+			if( p==NULL )
+				break;
+			mag->blocks[mag->count++] = p;
+		}
+		harbol_mutex_unlock(&shared->lock);
+		if( mag->count==0 )
+			return NULL;
+	}
+	
+	/// freed blocks are filed under the largest class they fill, so clear the whole block, realloc may grow into it in place.
+	void *const p = mag->blocks[--mag->count];
+	return zero ? memset(p, 0, _memnode_size(_memnode_from_ptr(p)) - HARBOL_MEMNODE_HDR) : p;
+}
+
+HARBOL_EXPORT void *harbol_mempool_shared_realloc(struct HarbolMemPool *const restrict mempool, void *const ptr, const size_t size)
+{
+	harbol_mempool_lock(mempool);
+	void *const p = harbol_mempool_realloc(mempool, ptr, size);
+	harbol_mempool_unlock(mempool);
+	return p;
+}
+
+HARBOL_EXPORT bool harbol_mempool_shared_free(struct HarbolMemPool *const restrict mempool, void *const ptr)
+{
+	struct HarbolMemPoolShared *const shared = mempool->shared;
+	if( ptr==NULL || ( uintptr_t )ptr - HARBOL_MEMNODE_HDR < mempool->stack.mem )
+		return false;
+	
+	/// read without the lock, neighbouring blocks only ever flip the header's flag bits.
+	const struct HarbolMemNode *const mem_node = _memnode_from_ptr(ptr);
+	const size_t size = _memnode_size(mem_node);
+	struct HarbolMagazine *const mags = ( shared==NULL || (mem_node->size & HARBOL_MEMNODE_FREE) || size < _mag_block_size(0) || size >= _mag_block_size(HARBOL_MAG_CLASSES) ) ? NULL : _mempool_magazines(shared);
+	if( mags==NULL ) {
+		harbol_mempool_lock(mempool);
+		const bool result = harbol_mempool_free(mempool, ptr);
+		harbol_mempool_unlock(mempool);
+		return result;
+	}
+	
+	/// blocks go to the largest class they can fully serve.
+	struct HarbolMagazine *const mag = &mags[size / 16 - 2];
+	if( mag->count==HARBOL_MAG_ROUNDS ) {
+		harbol_mutex_lock(&shared->lock);
+		while( mag->count > HARBOL_MAG_ROUNDS / 2 )
+			harbol_mempool_free(mempool, mag->blocks[--mag->count]);
+		harbol_mutex_unlock(&shared->lock);
+	}
+	mag->blocks[mag->count++] = ptr;
+	return true;
+}
+
+HARBOL_EXPORT void harbol_mempool_shared_drain(struct HarbolMemPool *const mempool)
+{
+	struct HarbolMemPoolShared *const shared = mempool->shared;
+	if( shared==NULL )
+		return;
 	
-	return total_remaining;
+	harbol_mutex_lock(&shared->lock);
+	for( size_t i=0; i<HARBOL_MAG_THREADS; i++ ) {
+		if( shared->mags[i]==NULL )
+			continue;
+		for( size_t c=0; c<HARBOL_MAG_CLASSES; c++ ) {
+			struct HarbolMagazine *const mag = &shared->mags[i][c];
+			while( mag->count > 0 )
+				harbol_mempool_free(mempool, mag->blocks[--mag->count]);
+		}
+	}
+	harbol_mutex_unlock(&shared->lock);
+}
+
+HARBOL_EXPORT size_t harbol_mempool_mem_remaining(const struct HarbolMemPool *const mempool)
+{
+	return harbol_cache_remaining(&mempool->stack) + mempool->free_bytes;
+}
+
+HARBOL_EXPORT size_t harbol_mempool_mem_in_use(const struct HarbolMemPool *const mempool)
+{
+	/// everything carved off the cache that isn't sitting in a bin, plus the cache's arena.
+	return (mempool->stack.mem + mempool->stack.size - mempool->stack.offs) - mempool->free_bytes + (mempool->stack.arena - mempool->stack.mem);
+}
+
+/// the cache's space is one block, of the bins only the highest non-empty one has to be looked through.
+/// not O(1) like the stats, it costs as many steps as that bin has blocks.
+HARBOL_EXPORT size_t harbol_mempool_largest_free(const struct HarbolMemPool *const mempool)
+{
+	size_t largest = harbol_cache_remaining(&mempool->stack);
+	if( mempool->bitmap != 0 ) {
+		for( const struct HarbolMemNode *n = mempool->bins[harbol_size_log2(mempool->bitmap)]; n != NULL; n = n->next )
+			if( _memnode_size(n) > largest )
+				largest = _memnode_size(n);
+	}
+	return largest;
 }
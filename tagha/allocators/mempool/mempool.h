@@ -8,42 +8,64 @@ extern "C" {
 #include "../../harbol_common_defines.h"
 #include "../../harbol_common_includes.h"
 #include "../cache/cache.h"
-
-
+#include "../vmem/vmem.h"
+#include "../../threads/threads.h"
+#include "../alloc_stats.h"
+
+
+/**
+ * Every block starts with its size. Sizes are pointer aligned,
+ * so the two lowest bits flag whether the block and its lower neighbor are free.
+ * The links only exist while the block is free, they overlay the allocated memory.
+ * Free blocks also keep a copy of their size in their last word (boundary tag)
+ * so the next block up can find them to coalesce.
+ */
 struct HarbolMemNode {
 	size_t size;
 	struct HarbolMemNode *next, *prev;
 };
 
-HARBOL_EXPORT NO_NULL NONNULL_RET struct HarbolMemNode *harbol_memnode_split(struct HarbolMemNode *const node, const size_t bytes);
-HARBOL_EXPORT NO_NULL void harbol_memnode_replace(struct HarbolMemNode *old, struct HarbolMemNode *replace);
-
-
-struct HarbolFreeList {
-	struct HarbolMemNode *head, *tail;
-	size_t len;
+enum {
+	HARBOL_MEMNODE_FREE      = 1,
+	HARBOL_MEMNODE_PREV_FREE = 2,
+	HARBOL_MEMNODE_FLAGS     = HARBOL_MEMNODE_FREE | HARBOL_MEMNODE_PREV_FREE,
+	
+	/// only the size stays in front of an allocation.
+	HARBOL_MEMNODE_HDR       = sizeof(size_t),
+	/// links + boundary tag have to fit once a block gets freed.
+	HARBOL_MEMNODE_MIN       = sizeof(struct HarbolMemNode) + sizeof(size_t),
+	
+	/// shared pools: magazine 'i' caches blocks of (i + 2) * 16 bytes, 32 to 144.
+	HARBOL_MAG_CLASSES       = 8,
+	HARBOL_MAG_ROUNDS        = 32, /// blocks a magazine holds.
+	HARBOL_MAG_THREADS       = 64, /// live threads past this many always lock the pool.
+	
+	/// bin 'i' holds free blocks sized [2^i, 2^(i+1)).
+	HARBOL_BIN_COUNT         = sizeof(size_t) * CHAR_BIT
 };
 
-struct HarbolMemPool;
-
-HARBOL_EXPORT NO_NULL void harbol_freelist_insert(struct HarbolMemPool *mempool, struct HarbolFreeList *list, struct HarbolMemNode *node, bool is_bucket);
-HARBOL_EXPORT NO_NULL NONNULL_RET struct HarbolMemNode *harbol_freelist_remove(struct HarbolFreeList *list, struct HarbolMemNode *node);
-HARBOL_EXPORT NO_NULL void harbol_freelist_insert_before(struct HarbolFreeList *list, struct HarbolMemNode *curr, struct HarbolMemNode *insert);
-HARBOL_EXPORT NO_NULL struct HarbolMemNode *harbol_freelist_find(struct HarbolFreeList *list, size_t size);
-
+/// freed small blocks cached by one thread, they stay allocated as far as the pool knows.
+struct HarbolMagazine {
+	size_t count;
+	void *blocks[HARBOL_MAG_ROUNDS];
+};
 
-enum {
-	HARBOL_BUCKET_SIZE = 8,
-	HARBOL_BUCKET_BITS = 3,
-	MEM_SPLIT_THRESHOLD = 32
+struct HarbolMemPoolShared {
+	struct HarbolMutex lock;
+	struct HarbolMagazine *mags[HARBOL_MAG_THREADS]; /// HARBOL_MAG_CLASSES per thread slot, made on first use.
 };
 
 struct HarbolMemPool {
-	struct HarbolFreeList
-		large, // large free list.
-		buckets[HARBOL_BUCKET_SIZE] // bucket free list for smaller allocations.
-	;
+	struct HarbolMemNode *bins[HARBOL_BIN_COUNT];
+	size_t bitmap;     /// bit 'i' is set when bin 'i' isn't empty.
+	size_t free_bytes; /// bytes held by the bins.
+	struct HarbolAllocStats stats;
 	struct HarbolCache stack;
+	struct HarbolMemNode top; /// stands in for the block past the end, its flags tell if the highest block is free.
+	/// blocks this big get zeroed by dropping their whole pages instead of memset, 0 always uses memset.
+	/// only for buffers from `harbol_vmem_*`.
+	size_t page_zero_min;
+	struct HarbolMemPoolShared *shared; /// set once the pool is shared between threads.
 };
 
 
@@ -52,11 +74,38 @@ HARBOL_EXPORT NO_NULL struct HarbolMemPool harbol_mempool_from_buffer(void *buf,
 HARBOL_EXPORT NO_NULL bool harbol_mempool_clear(struct HarbolMemPool *mempool);
 
 HARBOL_EXPORT NO_NULL void *harbol_mempool_alloc(struct HarbolMemPool *mempool, size_t bytes);
+HARBOL_EXPORT NO_NULL void *harbol_mempool_alloc_uninit(struct HarbolMemPool *mempool, size_t bytes);
 HARBOL_EXPORT NEVER_NULL(1) void *harbol_mempool_realloc(struct HarbolMemPool *mempool, void *ptr, size_t bytes);
 HARBOL_EXPORT NEVER_NULL(1) bool harbol_mempool_free(struct HarbolMemPool *mempool, void *ptr);
 HARBOL_EXPORT NO_NULL bool harbol_mempool_cleanup(struct HarbolMemPool *mempool, void **ptrref);
 
+/// the memory right past the pool's end has to be usable before growing into it.
+HARBOL_EXPORT NO_NULL bool harbol_mempool_grow(struct HarbolMemPool *mempool, size_t bytes);
+HARBOL_EXPORT NO_NULL size_t harbol_mempool_shrink(struct HarbolMemPool *mempool, size_t bytes);
+
+/// drops every block below 'mark' & past the first 'size' bytes of the pool in O(1), the blocks between stay allocated.
+HARBOL_EXPORT NO_NULL bool harbol_mempool_rewind(struct HarbolMemPool *mempool, uintptr_t mark, size_t size);
+
+/**
+ * Shared pools let several threads allocate & free at once.
+ * Each thread caches freed small blocks in its own magazines & only locks the pool
+ * to refill an empty magazine or flush half of a full one.
+ * Everything else (growing, rewinding, stats) has to hold `harbol_mempool_lock` or run while no other thread uses the pool.
+ */
+HARBOL_EXPORT NO_NULL bool harbol_mempool_share(struct HarbolMemPool *mempool);
+HARBOL_EXPORT NO_NULL void harbol_mempool_unshare(struct HarbolMemPool *mempool);
+HARBOL_EXPORT NO_NULL void harbol_mempool_lock(const struct HarbolMemPool *mempool);
+HARBOL_EXPORT NO_NULL void harbol_mempool_unlock(const struct HarbolMemPool *mempool);
+
+HARBOL_EXPORT NO_NULL void *harbol_mempool_shared_alloc(struct HarbolMemPool *mempool, size_t bytes, bool zero);
+HARBOL_EXPORT NEVER_NULL(1) void *harbol_mempool_shared_realloc(struct HarbolMemPool *mempool, void *ptr, size_t bytes);
+HARBOL_EXPORT NEVER_NULL(1) bool harbol_mempool_shared_free(struct HarbolMemPool *mempool, void *ptr);
+/// gives every thread's cached blocks back to the pool.
+HARBOL_EXPORT NO_NULL void harbol_mempool_shared_drain(struct HarbolMemPool *mempool);
+
 HARBOL_EXPORT NO_NULL size_t harbol_mempool_mem_remaining(const struct HarbolMemPool *mempool);
+HARBOL_EXPORT NO_NULL size_t harbol_mempool_mem_in_use(const struct HarbolMemPool *mempool);
+HARBOL_EXPORT NO_NULL size_t harbol_mempool_largest_free(const struct HarbolMemPool *mempool);
 /********************************************************************/
 
 #ifdef __cplusplus
@@ -0,0 +1,241 @@
+#include "slab.h"
+
+#ifdef OS_WINDOWS
+#	define HARBOL_LIB
+#endif
+
+
+static inline size_t _slab_objs_offset(void)
+{
+	return harbol_align_size(sizeof(struct HarbolSlab), 16);
+}
+
+static inline size_t _slab_capacity(const size_t obj_size)
+{
+	return (HARBOL_SLAB_SIZE - _slab_objs_offset()) / obj_size;
+}
+
+static inline size_t _slab_lowest_bit(const uint64_t n)
+{
+#if defined(COMPILER_CLANG) || defined(COMPILER_GCC)
+	return ( size_t )__builtin_ctzll(n);
+#else
+	size_t i = 0;
+	while( !(n & (( uint64_t )1 << i)) )
+		i++;
+	return i;
+#endif
+}
+
+static NO_NULL void _slab_push(struct HarbolSlab **const list, struct HarbolSlab *const slab)
+{
+	slab->prev = NULL;
+	slab->next = *list;
+	if( slab->next != NULL )
+		slab->next->prev = slab;
+	*list = slab;
+}
+
+static NO_NULL void _slab_unlink(struct HarbolSlab **const list, struct HarbolSlab *const slab)
+{
+	if( slab->prev != NULL )
+		slab->prev->next = slab->next;
+	else *list = slab->next;
+	if( slab->next != NULL )
+		slab->next->prev = slab->prev;
+	slab->next = slab->prev = NULL;
+}
+
+static inline NO_NULL size_t _slab_page_index(const struct HarbolSlabAlloc *const slabs, const uintptr_t page)
+{
+	return (page - slabs->page_base) / HARBOL_SLAB_SIZE;
+}
+
+/// NULL if 'ptr' isn't inside a slab.
+static NO_NULL struct HarbolSlab *_slab_of(const struct HarbolSlabAlloc *const slabs, const uintptr_t ptr)
+{
+	const struct HarbolCache *const cache = &slabs->pool->stack;
+	const uintptr_t page = ptr & -( uintptr_t )HARBOL_SLAB_SIZE;
+	if( slabs->page_map==NULL || page < cache->offs || ptr >= cache->mem + cache->size )
+		return NULL;
+	else {
+		/// pages past `page_count` were added by growing the pool, slabs are never made there.
+		const size_t i = _slab_page_index(slabs, page);
+		return( i < slabs->page_count && (slabs->page_map[i >> 3] & (1u << (i & 7))) ) ? ( struct HarbolSlab* )page : NULL;
+	}
+}
+
+/// carves a page aligned slab off the top of the pool's cache.
+static NO_NULL struct HarbolSlab *_slab_new(struct HarbolSlabAlloc *const slabs, const size_t obj_size)
+{
+	struct HarbolCache *const cache = &slabs->pool->stack;
+	const uintptr_t top = cache->offs;
+	if( slabs->page_map==NULL || harbol_cache_remaining(cache) < HARBOL_SLAB_SIZE )
+		return NULL;
+	
+	const uintptr_t slab_addr = (top - HARBOL_SLAB_SIZE) & -( uintptr_t )HARBOL_SLAB_SIZE;
+	if( slab_addr < cache->arena || _slab_page_index(slabs, slab_addr) >= slabs->page_count )
+		return NULL;
+	
+	cache->offs = slab_addr;
+	struct HarbolSlab *const slab = ( struct HarbolSlab* )slab_addr;
+	*slab = (struct HarbolSlab){ .size = top - slab_addr, .obj_size = ( uint32_t )obj_size };
+	
+	/// the alignment gap above the slab goes back to the pool if it's big enough to be a block.
+	/// both were carved like allocations, the pool's stats count them as such so their frees balance out.
+	const size_t slack = slab->size - HARBOL_SLAB_SIZE;
+	if( slack >= HARBOL_MEMNODE_MIN ) {
+		struct HarbolMemNode *const rest = ( struct HarbolMemNode* )(slab_addr + HARBOL_SLAB_SIZE);
+		rest->size = slack;
+		slab->size = HARBOL_SLAB_SIZE;
+		harbol_stats_on_alloc(&slabs->pool->stats, slack, harbol_mempool_mem_in_use(slabs->pool));
+		harbol_mempool_free(slabs->pool, ( uint8_t* )rest + HARBOL_MEMNODE_HDR);
+	}
+	harbol_stats_on_alloc(&slabs->pool->stats, slab->size, harbol_mempool_mem_in_use(slabs->pool));
+	
+	const size_t i = _slab_page_index(slabs, slab_addr);
+	slabs->page_map[i >> 3] |= 1u << (i & 7);
+	return slab;
+}
+
+
+HARBOL_EXPORT struct HarbolSlabAlloc harbol_slab_create(struct HarbolMemPool *const pool)
+{
+	struct HarbolSlabAlloc slabs = { .pool = pool };
+	if( pool->stack.mem==0 )
+		return slabs;
+	
+	slabs.page_base  = pool->stack.mem & -( uintptr_t )HARBOL_SLAB_SIZE;
+	slabs.page_count = (pool->stack.mem + pool->stack.size - slabs.page_base + HARBOL_SLAB_SIZE - 1) / HARBOL_SLAB_SIZE;
+	/// without a page map every request simply goes to the pool.
+	slabs.page_map   = harbol_mempool_alloc(pool, (slabs.page_count + 7) / 8);
+	return slabs;
+}
+
+HARBOL_EXPORT bool harbol_slab_clear(struct HarbolSlabAlloc *const slabs)
+{
+	/// slabs live in the pool, clearing the pool releases them.
+	if( slabs->page_map==NULL )
+		return false;
+	else {
+		harbol_mempool_free(slabs->pool, slabs->page_map);
+		*slabs = (struct HarbolSlabAlloc){ 0 };
+		return true;
+	}
+}
+
+HARBOL_EXPORT void harbol_slab_reset(struct HarbolSlabAlloc *const slabs)
+{
+	memset(slabs->partial, 0, sizeof slabs->partial);
+	if( slabs->page_map != NULL )
+		memset(slabs->page_map, 0, (slabs->page_count + 7) / 8);
+}
+
+static NO_NULL void *_slab_alloc(struct HarbolSlabAlloc *const slabs, const size_t size, const bool zero)
+{
+	if( size==0 )
+		return NULL;
+	else if( size > HARBOL_SLAB_MAX_OBJ )
+		return zero ? harbol_mempool_alloc(slabs->pool, size) : harbol_mempool_alloc_uninit(slabs->pool, size);
+	
+	const size_t class = (size - 1) >> HARBOL_SLAB_CLASS_BITS;
+	const size_t obj_size = (class + 1) << HARBOL_SLAB_CLASS_BITS;
+	struct HarbolSlab *slab = slabs->partial[class];
+	if( slab==NULL ) {
+		slab = _slab_new(slabs, obj_size);
+		if( slab==NULL )
+			return zero ? harbol_mempool_alloc(slabs->pool, size) : harbol_mempool_alloc_uninit(slabs->pool, size);
+		_slab_push(&slabs->partial[class], slab);
+	}
+	
+	size_t w = 0;
+	while( slab->bitmap[w]==UINT64_MAX )
+		w++;
+	const size_t index = w * 64 + _slab_lowest_bit(~slab->bitmap[w]);
+	slab->bitmap[w] |= ( uint64_t )1 << (index & 63);
+	if( ++slab->used==_slab_capacity(obj_size) )
+		_slab_unlink(&slabs->partial[class], slab);
+	
+	uint8_t *const obj = ( uint8_t* )slab + _slab_objs_offset() + index * obj_size;
+	return zero ? memset(obj, 0, obj_size) : obj;
+}
+
+HARBOL_EXPORT void *harbol_slab_alloc(struct HarbolSlabAlloc *const slabs, const size_t size)
+{
+	return _slab_alloc(slabs, size, true);
+}
+
+HARBOL_EXPORT void *harbol_slab_alloc_uninit(struct HarbolSlabAlloc *const slabs, const size_t size)
+{
+	return _slab_alloc(slabs, size, false);
+}
+
+HARBOL_EXPORT void *harbol_slab_realloc(struct HarbolSlabAlloc *const restrict slabs, void *const ptr, const size_t size)
+{
+	if( ptr==NULL )
+		return harbol_slab_alloc(slabs, size);
+	
+	const struct HarbolSlab *const slab = _slab_of(slabs, ( uintptr_t )ptr);
+	if( slab==NULL )
+		return harbol_mempool_realloc(slabs->pool, ptr, size);
+	else if( size==0 )
+		return NULL;
+	/// still fits its slot.
+	else if( size <= slab->obj_size )
+		return ptr;
+	else {
+		uint8_t *const resized = harbol_slab_alloc(slabs, size);
+		if( resized==NULL )
+			return NULL;
+		else {
+			memcpy(resized, ptr, slab->obj_size);
+			harbol_slab_free(slabs, ptr);
+			return resized;
+		}
+	}
+}
+
+HARBOL_EXPORT bool harbol_slab_free(struct HarbolSlabAlloc *const restrict slabs, void *const ptr)
+{
+	if( ptr==NULL )
+		return false;
+	
+	struct HarbolSlab *const slab = _slab_of(slabs, ( uintptr_t )ptr);
+	if( slab==NULL )
+		return harbol_mempool_free(slabs->pool, ptr);
+	
+	const uintptr_t objs = ( uintptr_t )slab + _slab_objs_offset();
+	const size_t obj_size = slab->obj_size;
+	if( ( uintptr_t )ptr < objs || (( uintptr_t )ptr - objs) % obj_size != 0 )
+		return false;
+	
+	const size_t index = (( uintptr_t )ptr - objs) / obj_size;
+	const uint64_t bit = ( uint64_t )1 << (index & 63);
+	if( index >= _slab_capacity(obj_size) || !(slab->bitmap[index / 64] & bit) )
+		return false;
+	
+	struct HarbolSlab **const list = &slabs->partial[(obj_size >> HARBOL_SLAB_CLASS_BITS) - 1];
+	slab->bitmap[index / 64] &= ~bit;
+	if( slab->used-- ==_slab_capacity(obj_size) )
+		_slab_push(list, slab);
+	
+	if( slab->used==0 ) {
+		/// give the page back, the pool coalesces it like any other block.
+		_slab_unlink(list, slab);
+		const size_t i = _slab_page_index(slabs, ( uintptr_t )slab);
+		slabs->page_map[i >> 3] &= ~(1u << (i & 7));
+		harbol_mempool_free(slabs->pool, ( uint8_t* )slab + HARBOL_MEMNODE_HDR);
+	}
+	return true;
+}
+
+HARBOL_EXPORT bool harbol_slab_cleanup(struct HarbolSlabAlloc *const restrict slabs, void **const restrict ptrref)
+{
+	if( *ptrref==NULL )
+		return false;
+	else {
+		const bool free_result = harbol_slab_free(slabs, *ptrref);
+		*ptrref = NULL;
+		return free_result;
+	}
+}
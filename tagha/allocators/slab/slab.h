@@ -0,0 +1,61 @@
+#ifndef HARBOL_SLAB_INCLUDED
+#	define HARBOL_SLAB_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../harbol_common_defines.h"
+#include "../../harbol_common_includes.h"
+#include "../mempool/mempool.h"
+
+
+/**
+ * Slab front-end for a mempool.
+ * Small requests are served from page sized slabs, one size class per slab,
+ * with a bitmap for occupancy & no header in front of the objects.
+ * Slabs are carved page aligned from the pool's cache and look like an allocated block to the pool,
+ * so an empty slab is handed back with `harbol_mempool_free`.
+ * Requests over `HARBOL_SLAB_MAX_OBJ` bytes go straight to the mempool.
+ */
+enum {
+	HARBOL_SLAB_SIZE         = 4096,
+	HARBOL_SLAB_CLASS_BITS   = 4,
+	HARBOL_SLAB_MAX_OBJ      = 128,
+	HARBOL_SLAB_CLASSES      = HARBOL_SLAB_MAX_OBJ >> HARBOL_SLAB_CLASS_BITS, /// 16, 32, ... 128 bytes.
+	HARBOL_SLAB_BITMAP_WORDS = HARBOL_SLAB_SIZE / (16 * 64),
+};
+
+struct HarbolSlab {
+	size_t size;                      /// mempool block header, the pool sees the slab as an allocated block.
+	struct HarbolSlab *next, *prev;   /// links of the size class' partial list.
+	uint32_t obj_size, used;
+	uint64_t bitmap[HARBOL_SLAB_BITMAP_WORDS];
+};
+
+struct HarbolSlabAlloc {
+	struct HarbolMemPool *pool;
+	struct HarbolSlab *partial[HARBOL_SLAB_CLASSES]; /// slabs with at least one free object.
+	uint8_t *page_map;  /// bit per page of the pool's buffer, set if the page is a slab.
+	uintptr_t page_base;
+	size_t page_count;
+};
+
+
+HARBOL_EXPORT NO_NULL struct HarbolSlabAlloc harbol_slab_create(struct HarbolMemPool *pool);
+HARBOL_EXPORT NO_NULL bool harbol_slab_clear(struct HarbolSlabAlloc *slabs);
+/// forgets every slab, for when the pool was rewound under them.
+HARBOL_EXPORT NO_NULL void harbol_slab_reset(struct HarbolSlabAlloc *slabs);
+
+HARBOL_EXPORT NO_NULL void *harbol_slab_alloc(struct HarbolSlabAlloc *slabs, size_t bytes);
+HARBOL_EXPORT NO_NULL void *harbol_slab_alloc_uninit(struct HarbolSlabAlloc *slabs, size_t bytes);
+HARBOL_EXPORT NEVER_NULL(1) void *harbol_slab_realloc(struct HarbolSlabAlloc *slabs, void *ptr, size_t bytes);
+HARBOL_EXPORT NEVER_NULL(1) bool harbol_slab_free(struct HarbolSlabAlloc *slabs, void *ptr);
+HARBOL_EXPORT NO_NULL bool harbol_slab_cleanup(struct HarbolSlabAlloc *slabs, void **ptrref);
+/********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HARBOL_SLAB_INCLUDED */
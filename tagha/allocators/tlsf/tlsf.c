@@ -0,0 +1,283 @@
+#include "tlsf.h"
+
+#ifdef OS_WINDOWS
+#	define HARBOL_LIB
+#endif
+
+
+static inline size_t _tlsf_lowest_bit(const uint32_t n)
+{
+#if defined(COMPILER_CLANG) || defined(COMPILER_GCC)
+	return ( size_t )__builtin_ctz(n);
+#else
+	size_t i = 0;
+	while( !(n & (( uint32_t )1 << i)) )
+		i++;
+	return i;
+#endif
+}
+
+static inline size_t _tlsf_block_size(const struct HarbolTLSFBlock *const block)
+{
+	return block->size & ~( size_t )HARBOL_TLSF_FLAGS;
+}
+
+static inline NO_NULL struct HarbolTLSFBlock *_tlsf_block_above(const struct HarbolTLSF *const tlsf, struct HarbolTLSFBlock *const block, const size_t size)
+{
+	const uintptr_t above = ( uintptr_t )block + size;
+	return( above < tlsf->end ) ? ( struct HarbolTLSFBlock* )above : NULL;
+}
+
+/// list a block of 'size' belongs to.
+static inline void _tlsf_mapping_insert(const size_t size, size_t *const fl, size_t *const sl)
+{
+	if( size < HARBOL_TLSF_SMALL_BLOCK ) {
+		*fl = 0;
+		*sl = size / (HARBOL_TLSF_SMALL_BLOCK / HARBOL_TLSF_SL_COUNT);
+	} else {
+		const size_t l = harbol_size_log2(size);
+		*sl = (size >> (l - HARBOL_TLSF_SL_LOG2)) ^ HARBOL_TLSF_SL_COUNT;
+		*fl = l - (HARBOL_TLSF_FL_SHIFT - 1);
+	}
+}
+
+/// first list where every block fits 'size', so the search never has to walk a list.
+static inline void _tlsf_mapping_search(size_t size, size_t *const fl, size_t *const sl)
+{
+	if( size >= HARBOL_TLSF_SMALL_BLOCK )
+		size += (( size_t )1 << (harbol_size_log2(size) - HARBOL_TLSF_SL_LOG2)) - 1;
+	_tlsf_mapping_insert(size, fl, sl);
+}
+
+static NO_NULL void _tlsf_insert(struct HarbolTLSF *const tlsf, struct HarbolTLSFBlock *const block, const size_t size)
+{
+	size_t fl, sl;
+	_tlsf_mapping_insert(size, &fl, &sl);
+	struct HarbolTLSFBins *const bins = tlsf->bins;
+	block->size = size | HARBOL_TLSF_FREE;
+	*( size_t* )(( uintptr_t )block + size - sizeof(size_t)) = size;
+	block->prev = NULL;
+	block->next = bins->blocks[fl][sl];
+	if( block->next != NULL )
+		block->next->prev = block;
+	bins->blocks[fl][sl] = block;
+	bins->fl_bitmap |= 1u << fl;
+	bins->sl_bitmap[fl] |= 1u << sl;
+	tlsf->free_bytes += size;
+}
+
+static NO_NULL void _tlsf_remove(struct HarbolTLSF *const tlsf, struct HarbolTLSFBlock *const block)
+{
+	const size_t size = _tlsf_block_size(block);
+	size_t fl, sl;
+	_tlsf_mapping_insert(size, &fl, &sl);
+	struct HarbolTLSFBins *const bins = tlsf->bins;
+	if( block->prev != NULL )
+		block->prev->next = block->next;
+	else {
+		bins->blocks[fl][sl] = block->next;
+		if( block->next==NULL ) {
+			bins->sl_bitmap[fl] &= ~(1u << sl);
+			if( bins->sl_bitmap[fl]==0 )
+				bins->fl_bitmap &= ~(1u << fl);
+		}
+	}
+	if( block->next != NULL )
+		block->next->prev = block->prev;
+	block->size &= ~( size_t )HARBOL_TLSF_FREE;
+	tlsf->free_bytes -= size;
+}
+
+static NO_NULL struct HarbolTLSFBlock *_tlsf_find_suitable(const struct HarbolTLSFBins *const bins, size_t fl, const size_t sl)
+{
+	uint32_t sl_map = bins->sl_bitmap[fl] & (~0u << sl);
+	if( sl_map==0 ) {
+		const uint32_t fl_map = ( fl + 1 < HARBOL_TLSF_FL_COUNT ) ? bins->fl_bitmap & (~0u << (fl + 1)) : 0;
+		if( fl_map==0 )
+			return NULL;
+		fl = _tlsf_lowest_bit(fl_map);
+		sl_map = bins->sl_bitmap[fl];
+	}
+	return bins->blocks[fl][_tlsf_lowest_bit(sl_map)];
+}
+
+static inline size_t _tlsf_alloc_size(const size_t bytes)
+{
+	const size_t alloc_bytes = harbol_align_size(bytes + HARBOL_TLSF_HDR, HARBOL_TLSF_ALIGN);
+	return( alloc_bytes < HARBOL_TLSF_MIN_BLOCK ) ? HARBOL_TLSF_MIN_BLOCK : alloc_bytes;
+}
+
+
+HARBOL_EXPORT struct HarbolTLSF harbol_tlsf_create(const size_t size)
+{
+	struct HarbolTLSF tlsf = { 0 };
+	if( size==0 )
+		return tlsf;
+	else {
+		uint8_t *const restrict buf = calloc(size + HARBOL_TLSF_OVERHEAD, sizeof *buf);
+		if( buf==NULL )
+			return tlsf;
+		else {
+			tlsf = harbol_tlsf_from_buffer(buf, size + HARBOL_TLSF_OVERHEAD);
+			if( tlsf.bins==NULL )
+				free(buf);
+			return tlsf;
+		}
+	}
+}
+
+HARBOL_EXPORT struct HarbolTLSF harbol_tlsf_from_buffer(void *const restrict buf, const size_t size)
+{
+	struct HarbolTLSF tlsf = { 0 };
+	const uintptr_t base = ( uintptr_t )buf;
+	if( size <= HARBOL_TLSF_OVERHEAD + HARBOL_TLSF_MIN_BLOCK || size - HARBOL_TLSF_OVERHEAD > UINT32_MAX || (base & (sizeof(uintptr_t) - 1)) )
+		return tlsf;
+	else {
+		tlsf.bins = buf;
+		memset(tlsf.bins, 0, sizeof *tlsf.bins);
+		/// blocks start one header before an aligned address so that the memory they hand out is aligned.
+		const uintptr_t bins_end = base + sizeof *tlsf.bins;
+		tlsf.mem = harbol_align_size(bins_end + HARBOL_TLSF_HDR, HARBOL_TLSF_ALIGN) - HARBOL_TLSF_HDR;
+		const size_t block_size = (base + size - tlsf.mem) & -( size_t )HARBOL_TLSF_ALIGN;
+		tlsf.end = tlsf.mem + block_size;
+		_tlsf_insert(&tlsf, ( struct HarbolTLSFBlock* )tlsf.mem, block_size);
+		return tlsf;
+	}
+}
+
+HARBOL_EXPORT bool harbol_tlsf_clear(struct HarbolTLSF *const tlsf)
+{
+	if( tlsf->bins==NULL )
+		return false;
+	else {
+		free(tlsf->bins);
+		*tlsf = (struct HarbolTLSF){ 0 };
+		return true;
+	}
+}
+
+HARBOL_EXPORT void *harbol_tlsf_alloc(struct HarbolTLSF *const tlsf, const size_t size)
+{
+	uint8_t *const mem = harbol_tlsf_alloc_uninit(tlsf, size);
+	if( mem==NULL )
+		return NULL;
+	const struct HarbolTLSFBlock *const block = ( const struct HarbolTLSFBlock* )(mem - HARBOL_TLSF_HDR);
+	return memset(mem, 0, _tlsf_block_size(block) - HARBOL_TLSF_HDR);
+}
+
+HARBOL_EXPORT void *harbol_tlsf_alloc_uninit(struct HarbolTLSF *const tlsf, const size_t size)
+{
+	if( tlsf->bins==NULL || size==0 || size > tlsf->end - tlsf->mem )
+		return NULL;
+	
+	const size_t alloc_bytes = _tlsf_alloc_size(size);
+	size_t fl, sl;
+	_tlsf_mapping_search(alloc_bytes, &fl, &sl);
+	if( fl >= HARBOL_TLSF_FL_COUNT )
+		return NULL;
+	
+	struct HarbolTLSFBlock *block = _tlsf_find_suitable(tlsf->bins, fl, sl);
+	if( block==NULL )
+		return NULL;
+	
+	_tlsf_remove(tlsf, block);
+	const size_t block_size = _tlsf_block_size(block);
+	if( block_size - alloc_bytes >= HARBOL_TLSF_MIN_BLOCK ) {
+		/// hand out the upper part so the first allocations stay at the top of the buffer.
+		_tlsf_insert(tlsf, block, block_size - alloc_bytes);
+		block = ( struct HarbolTLSFBlock* )(( uintptr_t )block + block_size - alloc_bytes);
+		block->size = alloc_bytes | HARBOL_TLSF_PREV_FREE;
+	}
+	struct HarbolTLSFBlock *const above = _tlsf_block_above(tlsf, block, _tlsf_block_size(block));
+	if( above != NULL )
+		above->size &= ~( size_t )HARBOL_TLSF_PREV_FREE;
+	
+	harbol_stats_on_alloc(&tlsf->stats, _tlsf_block_size(block), harbol_tlsf_mem_in_use(tlsf));
+	return ( uint8_t* )block + HARBOL_TLSF_HDR;
+}
+
+HARBOL_EXPORT void *harbol_tlsf_realloc(struct HarbolTLSF *const restrict tlsf, void *const ptr, const size_t size)
+{
+	if( ptr==NULL )
+		return harbol_tlsf_alloc(tlsf, size);
+	else if( ( uintptr_t )ptr - HARBOL_TLSF_HDR < tlsf->mem || ( uintptr_t )ptr >= tlsf->end )
+		return NULL;
+	else {
+		const size_t old_size = _tlsf_block_size(( const struct HarbolTLSFBlock* )(( uintptr_t )ptr - HARBOL_TLSF_HDR)) - HARBOL_TLSF_HDR;
+		uint8_t *const resized_block = harbol_tlsf_alloc(tlsf, size);
+		if( resized_block==NULL )
+			return NULL;
+		else {
+			memcpy(resized_block, ptr, (old_size < size) ? old_size : size);
+			harbol_tlsf_free(tlsf, ptr);
+			return resized_block;
+		}
+	}
+}
+
+HARBOL_EXPORT bool harbol_tlsf_free(struct HarbolTLSF *const restrict tlsf, void *const ptr)
+{
+	const uintptr_t p = ( uintptr_t )ptr;
+	if( ptr==NULL || p - HARBOL_TLSF_HDR < tlsf->mem || p >= tlsf->end || (p & (HARBOL_TLSF_ALIGN - 1)) )
+		return false;
+	
+	struct HarbolTLSFBlock *block = ( struct HarbolTLSFBlock* )(p - HARBOL_TLSF_HDR);
+	size_t size = _tlsf_block_size(block);
+	if( (block->size & HARBOL_TLSF_FREE) || size < HARBOL_TLSF_MIN_BLOCK || size > tlsf->end - ( uintptr_t )block )
+		return false;
+	
+	harbol_stats_on_free(&tlsf->stats, size);
+	struct HarbolTLSFBlock *const above = _tlsf_block_above(tlsf, block, size);
+	if( above != NULL && (above->size & HARBOL_TLSF_FREE) ) {
+		_tlsf_remove(tlsf, above);
+		size += _tlsf_block_size(above);
+	}
+	if( block->size & HARBOL_TLSF_PREV_FREE ) {
+		const size_t below_size = *( const size_t* )(( uintptr_t )block - sizeof(size_t));
+		struct HarbolTLSFBlock *const below = ( struct HarbolTLSFBlock* )(( uintptr_t )block - below_size);
+		_tlsf_remove(tlsf, below);
+		size += below_size;
+		block = below;
+	}
+	_tlsf_insert(tlsf, block, size);
+	
+	struct HarbolTLSFBlock *const next = _tlsf_block_above(tlsf, block, size);
+	if( next != NULL )
+		next->size |= HARBOL_TLSF_PREV_FREE;
+	return true;
+}
+
+HARBOL_EXPORT bool harbol_tlsf_cleanup(struct HarbolTLSF *const restrict tlsf, void **const restrict ptrref)
+{
+	if( *ptrref==NULL )
+		return false;
+	else {
+		const bool free_result = harbol_tlsf_free(tlsf, *ptrref);
+		*ptrref = NULL;
+		return free_result;
+	}
+}
+
+HARBOL_EXPORT size_t harbol_tlsf_mem_remaining(const struct HarbolTLSF *const tlsf)
+{
+	return tlsf->free_bytes;
+}
+
+HARBOL_EXPORT size_t harbol_tlsf_mem_in_use(const struct HarbolTLSF *const tlsf)
+{
+	return (tlsf->end - tlsf->mem) - tlsf->free_bytes;
+}
+
+/// only the highest non-empty list has to be looked through, it costs as many steps as that list has blocks.
+HARBOL_EXPORT size_t harbol_tlsf_largest_free(const struct HarbolTLSF *const tlsf)
+{
+	size_t largest = 0;
+	if( tlsf->bins != NULL && tlsf->bins->fl_bitmap != 0 ) {
+		const size_t fl = harbol_size_log2(tlsf->bins->fl_bitmap);
+		const size_t sl = harbol_size_log2(tlsf->bins->sl_bitmap[fl]);
+		for( const struct HarbolTLSFBlock *b = tlsf->bins->blocks[fl][sl]; b != NULL; b = b->next )
+			if( _tlsf_block_size(b) > largest )
+				largest = _tlsf_block_size(b);
+	}
+	return largest;
+}
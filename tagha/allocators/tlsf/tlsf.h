@@ -0,0 +1,80 @@
+#ifndef HARBOL_TLSF_INCLUDED
+#	define HARBOL_TLSF_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../harbol_common_defines.h"
+#include "../../harbol_common_includes.h"
+#include "../alloc_stats.h"
+
+
+/**
+ * Two-Level Segregated Fit allocator.
+ * The first level splits block sizes by power of 2,
+ * the second level splits each power of 2 into `HARBOL_TLSF_SL_COUNT` linear ranges.
+ * Both levels are bitmap indexed so alloc & free are O(1) with a fixed worst case.
+ * Blocks use the same boundary tags as the mempool: size + free bits up front,
+ * free list links & a trailing size only while the block is free.
+ */
+struct HarbolTLSFBlock {
+	size_t size;
+	struct HarbolTLSFBlock *next, *prev;
+};
+
+enum {
+	HARBOL_TLSF_ALIGN_LOG2  = 4,
+	HARBOL_TLSF_ALIGN       = 1 << HARBOL_TLSF_ALIGN_LOG2, /// every allocation is aligned to this.
+	HARBOL_TLSF_SL_LOG2     = 4,
+	HARBOL_TLSF_SL_COUNT    = 1 << HARBOL_TLSF_SL_LOG2,
+	HARBOL_TLSF_FL_SHIFT    = HARBOL_TLSF_SL_LOG2 + HARBOL_TLSF_ALIGN_LOG2,
+	HARBOL_TLSF_SMALL_BLOCK = 1 << HARBOL_TLSF_FL_SHIFT,   /// sizes under this all share the first list.
+	HARBOL_TLSF_FL_COUNT    = 32 - HARBOL_TLSF_FL_SHIFT + 1, /// pools up to 4GiB.
+	
+	HARBOL_TLSF_FREE        = 1,
+	HARBOL_TLSF_PREV_FREE   = 2,
+	HARBOL_TLSF_FLAGS       = HARBOL_TLSF_FREE | HARBOL_TLSF_PREV_FREE,
+	HARBOL_TLSF_HDR         = sizeof(size_t),
+	HARBOL_TLSF_MIN_BLOCK   = HARBOL_TLSF_ALIGN * 2,
+};
+
+struct HarbolTLSFBins {
+	uint32_t fl_bitmap;
+	uint32_t sl_bitmap[HARBOL_TLSF_FL_COUNT];
+	struct HarbolTLSFBlock *blocks[HARBOL_TLSF_FL_COUNT][HARBOL_TLSF_SL_COUNT];
+};
+
+enum {
+	/// bytes of a buffer used for the bins & alignment instead of blocks.
+	HARBOL_TLSF_OVERHEAD = sizeof(struct HarbolTLSFBins) + HARBOL_TLSF_ALIGN * 2,
+};
+
+struct HarbolTLSF {
+	struct HarbolTLSFBins *bins; /// kept at the front of the buffer.
+	uintptr_t mem, end;          /// first block & end of the last block.
+	size_t free_bytes;
+	struct HarbolAllocStats stats;
+};
+
+
+HARBOL_EXPORT struct HarbolTLSF harbol_tlsf_create(size_t bytes);
+HARBOL_EXPORT NO_NULL struct HarbolTLSF harbol_tlsf_from_buffer(void *buf, size_t bytes);
+HARBOL_EXPORT NO_NULL bool harbol_tlsf_clear(struct HarbolTLSF *tlsf);
+
+HARBOL_EXPORT NO_NULL void *harbol_tlsf_alloc(struct HarbolTLSF *tlsf, size_t bytes);
+HARBOL_EXPORT NO_NULL void *harbol_tlsf_alloc_uninit(struct HarbolTLSF *tlsf, size_t bytes);
+HARBOL_EXPORT NEVER_NULL(1) void *harbol_tlsf_realloc(struct HarbolTLSF *tlsf, void *ptr, size_t bytes);
+HARBOL_EXPORT NEVER_NULL(1) bool harbol_tlsf_free(struct HarbolTLSF *tlsf, void *ptr);
+HARBOL_EXPORT NO_NULL bool harbol_tlsf_cleanup(struct HarbolTLSF *tlsf, void **ptrref);
+
+HARBOL_EXPORT NO_NULL size_t harbol_tlsf_mem_remaining(const struct HarbolTLSF *tlsf);
+HARBOL_EXPORT NO_NULL size_t harbol_tlsf_mem_in_use(const struct HarbolTLSF *tlsf);
+HARBOL_EXPORT NO_NULL size_t harbol_tlsf_largest_free(const struct HarbolTLSF *tlsf);
+/********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HARBOL_TLSF_INCLUDED */
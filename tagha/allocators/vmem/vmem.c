@@ -0,0 +1,167 @@
+/// for MAP_ANONYMOUS & madvise under -std=c99.
+#define _DEFAULT_SOURCE
+
+#include "vmem.h"
+
+#ifdef OS_WINDOWS
+#	define HARBOL_LIB
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+
+HARBOL_EXPORT size_t harbol_vmem_page_size(void)
+{
+	static size_t page_size = 0;
+	if( page_size==0 ) {
+#ifdef OS_WINDOWS
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		page_size = info.dwPageSize;
+#else
+		const long size = sysconf(_SC_PAGESIZE);
+		page_size = ( size > 0 ) ? ( size_t )size : 4096;
+#endif
+	}
+	return page_size;
+}
+
+HARBOL_EXPORT void *harbol_vmem_reserve(const size_t bytes)
+{
+	if( bytes==0 )
+		return NULL;
+#ifdef OS_WINDOWS
+	return VirtualAlloc(NULL, bytes, MEM_RESERVE, PAGE_NOACCESS);
+#else
+	void *const mem = mmap(NULL, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return( mem==MAP_FAILED ) ? NULL : mem;
+#endif
+}
+
+HARBOL_EXPORT bool harbol_vmem_commit(void *const addr, const size_t bytes)
+{
+#ifdef OS_WINDOWS
+	return VirtualAlloc(addr, bytes, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+	return mprotect(addr, bytes, PROT_READ | PROT_WRITE)==0;
+#endif
+}
+
+HARBOL_EXPORT bool harbol_vmem_decommit(void *const addr, const size_t bytes)
+{
+#ifdef OS_WINDOWS
+	return VirtualFree(addr, bytes, MEM_DECOMMIT) != 0;
+#else
+	/// dropping the pages first so they're zeroed if committed again.
+	return madvise(addr, bytes, MADV_DONTNEED)==0 && mprotect(addr, bytes, PROT_NONE)==0;
+#endif
+}
+
+HARBOL_EXPORT bool harbol_vmem_release(void *const addr, const size_t bytes)
+{
+#ifdef OS_WINDOWS
+	( void )bytes;
+	return VirtualFree(addr, 0, MEM_RELEASE) != 0;
+#else
+	return munmap(addr, bytes)==0;
+#endif
+}
+
+HARBOL_EXPORT void *harbol_vmem_reserve_aligned(const size_t bytes, const size_t align)
+{
+	if( bytes==0 || align <= harbol_vmem_page_size() )
+		return harbol_vmem_reserve(bytes);
+#ifdef OS_WINDOWS
+	/// Windows can't release part of a reservation, look for an aligned spot & take it.
+	for( size_t tries=0; tries<8; tries++ ) {
+		uint8_t *const probe = harbol_vmem_reserve(bytes + align);
+		if( probe==NULL )
+			return NULL;
+		const uintptr_t aligned = (( uintptr_t )probe + align - 1) & -( uintptr_t )align;
+		harbol_vmem_release(probe, bytes + align);
+		void *const mem = VirtualAlloc(( void* )aligned, bytes, MEM_RESERVE, PAGE_NOACCESS);
+		if( mem != NULL )
+			return mem;
+	}
+	return harbol_vmem_reserve(bytes);
+#else
+	/// over-reserve, then give back the unaligned head & the tail.
+	uint8_t *const mem = harbol_vmem_reserve(bytes + align);
+	if( mem==NULL )
+		return NULL;
+	uint8_t *const aligned = ( uint8_t* )((( uintptr_t )mem + align - 1) & -( uintptr_t )align);
+	const size_t head = ( size_t )(aligned - mem);
+	if( head != 0 )
+		munmap(mem, head);
+	munmap(aligned + bytes, align - head);
+	return aligned;
+#endif
+}
+
+HARBOL_EXPORT void *harbol_vmem_map_huge(const size_t bytes)
+{
+#if defined(OS_WINDOWS) || !defined(MAP_HUGETLB)
+	( void )bytes;
+	return NULL;
+#else
+	if( bytes==0 || bytes % HARBOL_VMEM_HUGE_PAGE_SIZE != 0 )
+		return NULL;
+	void *const mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	return( mem==MAP_FAILED ) ? NULL : mem;
+#endif
+}
+
+HARBOL_EXPORT bool harbol_vmem_advise_huge(void *const addr, const size_t bytes)
+{
+#if defined(OS_WINDOWS) || !defined(MADV_HUGEPAGE)
+	( void )addr; ( void )bytes;
+	return false;
+#else
+	return madvise(addr, bytes, MADV_HUGEPAGE)==0;
+#endif
+}
+
+HARBOL_EXPORT bool harbol_vmem_prefault(void *const addr, const size_t bytes)
+{
+#if defined(MADV_POPULATE_WRITE)
+	if( madvise(addr, bytes, MADV_POPULATE_WRITE)==0 )
+		return true;
+#endif
+	/// writing a page's first byte back faults it in without changing it.
+	volatile uint8_t *const mem = addr;
+	const size_t page = harbol_vmem_page_size();
+	for( size_t i=0; i<bytes; i += page )
+		mem[i] = mem[i];
+	return true;
+}
+
+HARBOL_EXPORT bool harbol_vmem_zero(void *const addr, const size_t bytes)
+{
+#ifdef OS_WINDOWS
+	/// recommitted pages come back zeroed.
+	return VirtualFree(addr, bytes, MEM_DECOMMIT) != 0 && VirtualAlloc(addr, bytes, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+	/// private anonymous pages are zero filled on their next touch.
+	return madvise(addr, bytes, MADV_DONTNEED)==0;
+#endif
+}
+
+HARBOL_EXPORT bool harbol_vmem_lock(void *const addr, const size_t bytes)
+{
+#ifdef OS_WINDOWS
+	return VirtualLock(addr, bytes) != 0;
+#else
+	return mlock(addr, bytes)==0;
+#endif
+}
+
+HARBOL_EXPORT bool harbol_vmem_unlock(void *const addr, const size_t bytes)
+{
+#ifdef OS_WINDOWS
+	return VirtualUnlock(addr, bytes) != 0;
+#else
+	return munlock(addr, bytes)==0;
+#endif
+}
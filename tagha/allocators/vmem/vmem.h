@@ -0,0 +1,50 @@
+#ifndef HARBOL_VMEM_INCLUDED
+#	define HARBOL_VMEM_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../harbol_common_defines.h"
+#include "../../harbol_common_includes.h"
+
+
+/**
+ * Page granular virtual memory.
+ * A reserved range takes up address space only, its pages
+ * use memory once committed & go back to the OS once decommitted.
+ * Committed pages always start out zeroed.
+ * Sizes & addresses have to be multiples of `harbol_vmem_page_size()`.
+ */
+HARBOL_EXPORT size_t harbol_vmem_page_size(void);
+
+/// huge page size assumed for alignment, 2 MiB on x86-64 & most arm64 systems.
+#define HARBOL_VMEM_HUGE_PAGE_SIZE    (2u * 1024u * 1024u)
+
+HARBOL_EXPORT void *harbol_vmem_reserve(size_t bytes);
+HARBOL_EXPORT NO_NULL bool harbol_vmem_commit(void *addr, size_t bytes);
+HARBOL_EXPORT NO_NULL bool harbol_vmem_decommit(void *addr, size_t bytes);
+HARBOL_EXPORT NO_NULL bool harbol_vmem_release(void *addr, size_t bytes);
+
+/// 'align' has to be a power of 2 multiple of the page size.
+HARBOL_EXPORT void *harbol_vmem_reserve_aligned(size_t bytes, size_t align);
+
+/// explicit huge pages (MAP_HUGETLB), committed right away, NULL when the system has none set aside.
+HARBOL_EXPORT void *harbol_vmem_map_huge(size_t bytes);
+/// asks for transparent huge pages over a range, works on reserved pages too.
+HARBOL_EXPORT NO_NULL bool harbol_vmem_advise_huge(void *addr, size_t bytes);
+
+/// faults committed pages in so first accesses don't page fault.
+HARBOL_EXPORT NO_NULL bool harbol_vmem_prefault(void *addr, size_t bytes);
+/// committed pages read back as zero afterwards, false if they couldn't be dropped. (locked pages can't)
+HARBOL_EXPORT NO_NULL bool harbol_vmem_zero(void *addr, size_t bytes);
+HARBOL_EXPORT NO_NULL bool harbol_vmem_lock(void *addr, size_t bytes);
+HARBOL_EXPORT NO_NULL bool harbol_vmem_unlock(void *addr, size_t bytes);
+/********************************************************************/
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HARBOL_VMEM_INCLUDED */
@@ -260,6 +260,15 @@
 #	endif
 #endif
 
+/* setup macro to keep a function out of line, so rarely taken paths don't burden the register allocation of a hot function. */
+#ifndef NO_INLINE
+#	if defined(COMPILER_CLANG) || defined(COMPILER_GCC)
+#		define NO_INLINE __attribute__ ((noinline))
+#	else
+#		define NO_INLINE
+#	endif
+#endif
+
 /* setup macro to make vector types. Argument must be power of 2.
  * Example:
 	typedef __attribute__ ((vector_size (32))) int int_vec32_t; which makes int_vec32_t as 32-bytes.
@@ -0,0 +1,500 @@
+/// for syscall, pread & pwrite under -std=c99.
+#define _GNU_SOURCE
+
+#include "loop.h"
+
+#ifndef OS_WINDOWS
+#	include <errno.h>
+#	include <time.h>
+#	include <unistd.h>
+#endif
+
+#ifdef __linux__
+#	include <sys/epoll.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <sys/uio.h>
+#	include <linux/io_uring.h>
+#endif
+
+
+enum TaghaLoopOp { TaghaLoopOpNone, TaghaLoopOpRead, TaghaLoopOpWrite, TaghaLoopOpSleep };
+
+#ifndef OS_WINDOWS
+/// results follow io_uring's, bytes moved or -errno.
+static int64_t _tagha_loop_io_now(const int op, const int fd, void *const buf, const size_t len, const int64_t offset)
+{
+	ssize_t moved;
+	if( op==TaghaLoopOpRead )
+		moved = ( offset < 0 ) ? read(fd, buf, len) : pread(fd, buf, len, offset);
+	else moved = ( offset < 0 ) ? write(fd, buf, len) : pwrite(fd, buf, len, offset);
+	return ( moved < 0 ) ? -errno : moved;
+}
+
+static void _tagha_loop_sleep_now(const uint64_t ns)
+{
+	struct timespec ts = { .tv_sec = ( time_t )(ns / 1000000000u), .tv_nsec = ( long )(ns % 1000000000u) };
+	while( nanosleep(&ts, &ts) != 0 && errno==EINTR );
+}
+#endif
+
+
+#ifdef __linux__
+struct TaghaLoopCall {
+	struct TaghaLoopCall *next;
+	struct TaghaLoop     *loop;
+	struct TaghaModule   *module;
+	TaghaFunc             func;
+	TaghaTaskCallback    *on_done;
+	void                 *data;
+	union TaghaVal        result, io_result; /// the call's return value & what the finished operation hands the native.
+	struct iovec          iov;
+	struct __kernel_timespec ts;
+	uint64_t              deadline; /// CLOCK_MONOTONIC ns a sleep ends at under epoll.
+	int64_t               offset;
+	int                   fd, op;
+	bool                  started;
+	size_t                args;
+	union TaghaVal        params[];
+};
+
+/// loop call running on this thread.
+static HARBOL_THREAD_LOCAL struct TaghaLoopCall *_loop_call = NULL;
+
+static uint64_t _tagha_loop_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ( uint64_t )ts.tv_sec * 1000000000u + ( uint64_t )ts.tv_nsec;
+}
+
+static NO_NULL void _tagha_loop_ready(struct TaghaLoop *const restrict loop, struct TaghaLoopCall *const restrict call)
+{
+	call->next = NULL;
+	if( loop->ready_tail != NULL )
+		loop->ready_tail->next = call;
+	else loop->ready = call;
+	loop->ready_tail = call;
+}
+
+
+static NO_NULL bool _tagha_loop_timer_push(struct TaghaLoop *const restrict loop, struct TaghaLoopCall *const restrict call)
+{
+	if( loop->timers_len==loop->timers_cap ) {
+		const size_t cap = ( loop->timers_cap==0 ) ? 64 : loop->timers_cap * 2;
+		struct TaghaLoopCall **const timers = realloc(loop->timers, sizeof *timers * cap);
+		if( timers==NULL )
+			return false;
+		loop->timers = timers;
+		loop->timers_cap = cap;
+	}
+	call->deadline = _tagha_loop_now() + ( uint64_t )call->ts.tv_sec * 1000000000u + ( uint64_t )call->ts.tv_nsec;
+	size_t i = loop->timers_len++;
+	while( i > 0 && loop->timers[(i - 1) / 2]->deadline > call->deadline ) {
+		loop->timers[i] = loop->timers[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	loop->timers[i] = call;
+	return true;
+}
+
+static NO_NULL struct TaghaLoopCall *_tagha_loop_timer_pop(struct TaghaLoop *const loop)
+{
+	struct TaghaLoopCall *const top = loop->timers[0];
+	struct TaghaLoopCall *const last = loop->timers[--loop->timers_len];
+	size_t i = 0;
+	for( ;; ) {
+		size_t child = i * 2 + 1;
+		if( child >= loop->timers_len )
+			break;
+		else if( child + 1 < loop->timers_len && loop->timers[child + 1]->deadline < loop->timers[child]->deadline )
+			child++;
+		
+		if( last->deadline <= loop->timers[child]->deadline )
+			break;
+		loop->timers[i] = loop->timers[child];
+		i = child;
+	}
+	if( loop->timers_len > 0 )
+		loop->timers[i] = last;
+	return top;
+}
+
+
+/// the kernel has to keep completions it has no room for & take -1 as "the file's position".
+static NO_NULL bool _tagha_uring_init(struct TaghaLoop *const loop, const uint32_t entries)
+{
+	struct io_uring_params params = { 0 };
+	const int fd = ( int )syscall(__NR_io_uring_setup, entries, &params);
+	if( fd < 0 )
+		return false;
+	else if( (params.features & (IORING_FEAT_NODROP | IORING_FEAT_RW_CUR_POS)) != (IORING_FEAT_NODROP | IORING_FEAT_RW_CUR_POS) ) {
+		close(fd);
+		return false;
+	}
+	
+	struct TaghaLoopRing *const ring = &loop->ring;
+	ring->sq_map_len = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	ring->cq_map_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	ring->sqes_len   = params.sq_entries * sizeof(struct io_uring_sqe);
+	/// newer kernels map both rings at once.
+	const bool single_map = params.features & IORING_FEAT_SINGLE_MMAP;
+	if( single_map && ring->cq_map_len > ring->sq_map_len )
+		ring->sq_map_len = ring->cq_map_len;
+	
+	ring->sq_map = mmap(NULL, ring->sq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	ring->cq_map = ( single_map ) ? ring->sq_map : mmap(NULL, ring->cq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+	ring->sqes   = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if( ring->sq_map==MAP_FAILED || ring->cq_map==MAP_FAILED || ring->sqes==MAP_FAILED ) {
+		if( ring->sqes != MAP_FAILED )
+			munmap(ring->sqes, ring->sqes_len);
+		if( !single_map && ring->cq_map != MAP_FAILED )
+			munmap(ring->cq_map, ring->cq_map_len);
+		if( ring->sq_map != MAP_FAILED )
+			munmap(ring->sq_map, ring->sq_map_len);
+		close(fd);
+		*ring = (struct TaghaLoopRing){ 0 };
+		return false;
+	}
+	
+	uint8_t *const sq = ring->sq_map, *const cq = ring->cq_map;
+	ring->sq_head    = ( volatile uint32_t* )(sq + params.sq_off.head);
+	ring->sq_tail    = ( volatile uint32_t* )(sq + params.sq_off.tail);
+	ring->sq_array   = ( volatile uint32_t* )(sq + params.sq_off.array);
+	ring->sq_mask    = *( const uint32_t* )(sq + params.sq_off.ring_mask);
+	ring->sq_entries = params.sq_entries;
+	ring->cq_head    = ( volatile uint32_t* )(cq + params.cq_off.head);
+	ring->cq_tail    = ( volatile uint32_t* )(cq + params.cq_off.tail);
+	ring->cq_mask    = *( const uint32_t* )(cq + params.cq_off.ring_mask);
+	ring->cqes       = cq + params.cq_off.cqes;
+	loop->fd    = fd;
+	loop->uring = true;
+	return true;
+}
+
+/// submits the queued operations & waits for one to complete if 'wait'.
+static NO_NULL void _tagha_uring_enter(struct TaghaLoop *const loop, const bool wait)
+{
+	struct TaghaLoopRing *const ring = &loop->ring;
+	const int submitted = ( int )syscall(__NR_io_uring_enter, loop->fd, ring->unsubmitted, wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	if( submitted > 0 )
+		ring->unsubmitted -= ( uint32_t )submitted;
+}
+
+static NO_NULL bool _tagha_uring_push(struct TaghaLoop *const restrict loop, struct TaghaLoopCall *const restrict call)
+{
+	struct TaghaLoopRing *const ring = &loop->ring;
+	const uint32_t tail = *ring->sq_tail;
+	if( tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries ) {
+		_tagha_uring_enter(loop, false);
+		if( tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries )
+			return false;
+	}
+	
+	const uint32_t index = tail & ring->sq_mask;
+	struct io_uring_sqe *const sqe = ( struct io_uring_sqe* )ring->sqes + index;
+	memset(sqe, 0, sizeof *sqe);
+	sqe->user_data = ( uintptr_t )call;
+	if( call->op==TaghaLoopOpSleep ) {
+		sqe->opcode = IORING_OP_TIMEOUT;
+		sqe->fd     = -1;
+		sqe->addr   = ( uintptr_t )&call->ts;
+		sqe->len    = 1;
+	} else {
+		sqe->opcode = ( call->op==TaghaLoopOpRead ) ? IORING_OP_READV : IORING_OP_WRITEV;
+		sqe->fd     = call->fd;
+		sqe->addr   = ( uintptr_t )&call->iov;
+		sqe->len    = 1;
+		sqe->off    = ( call->offset < 0 ) ? ( uint64_t )-1 : ( uint64_t )call->offset;
+	}
+	ring->sq_array[index] = index;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	ring->unsubmitted++;
+	return true;
+}
+
+static NO_NULL void _tagha_uring_reap(struct TaghaLoop *const loop)
+{
+	struct TaghaLoopRing *const ring = &loop->ring;
+	uint32_t head = *ring->cq_head;
+	const uint32_t tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+	for( ; head != tail; head++ ) {
+		const struct io_uring_cqe *const cqe = ( const struct io_uring_cqe* )ring->cqes + (head & ring->cq_mask);
+		struct TaghaLoopCall *const call = ( struct TaghaLoopCall* )( uintptr_t )cqe->user_data;
+		/// a timeout that ran its course reports -ETIME.
+		call->io_result.int64 = ( call->op==TaghaLoopOpSleep && cqe->res==-ETIME ) ? 0 : cqe->res;
+		_tagha_loop_ready(loop, call);
+	}
+	__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+
+/// epoll refuses regular files, they're always ready & the operation runs in place instead.
+static NO_NULL bool _tagha_epoll_push(struct TaghaLoop *const restrict loop, struct TaghaLoopCall *const restrict call)
+{
+	if( call->op==TaghaLoopOpSleep )
+		return _tagha_loop_timer_push(loop, call);
+	
+	struct epoll_event event = { .events = (( call->op==TaghaLoopOpRead ) ? EPOLLIN : EPOLLOUT) | EPOLLONESHOT, .data.ptr = call };
+	return epoll_ctl(loop->fd, EPOLL_CTL_ADD, call->fd, &event)==0;
+}
+
+static NO_NULL void _tagha_epoll_wait(struct TaghaLoop *const loop, const bool wait)
+{
+	int timeout = ( wait ) ? -1 : 0;
+	if( wait && loop->timers_len > 0 ) {
+		const uint64_t now = _tagha_loop_now(), due = loop->timers[0]->deadline;
+		const uint64_t ms = ( due > now ) ? (due - now + 999999u) / 1000000u : 0;
+		timeout = ( ms > INT32_MAX ) ? INT32_MAX : ( int )ms;
+	}
+	
+	struct epoll_event events[64];
+	const int count = epoll_wait(loop->fd, events, sizeof events / sizeof events[0], timeout);
+	for( int i=0; i<count; i++ ) {
+		struct TaghaLoopCall *const call = events[i].data.ptr;
+		epoll_ctl(loop->fd, EPOLL_CTL_DEL, call->fd, NULL);
+		call->io_result.int64 = _tagha_loop_io_now(call->op, call->fd, call->iov.iov_base, call->iov.iov_len, call->offset);
+		_tagha_loop_ready(loop, call);
+	}
+	
+	const uint64_t now = _tagha_loop_now();
+	while( loop->timers_len > 0 && loop->timers[0]->deadline <= now ) {
+		struct TaghaLoopCall *const call = _tagha_loop_timer_pop(loop);
+		call->io_result.int64 = 0;
+		_tagha_loop_ready(loop, call);
+	}
+}
+
+
+static NO_NULL void _tagha_loop_submit(struct TaghaLoop *const restrict loop, struct TaghaLoopCall *const restrict call)
+{
+	if( loop->uring ? _tagha_uring_push(loop, call) : _tagha_epoll_push(loop, call) )
+		return;
+	
+	/// nowhere to queue it, the operation runs now & the call resumes on the next turn.
+	if( call->op==TaghaLoopOpSleep ) {
+		_tagha_loop_sleep_now(( uint64_t )call->ts.tv_sec * 1000000000u + ( uint64_t )call->ts.tv_nsec);
+		call->io_result.int64 = 0;
+	} else {
+		call->io_result.int64 = _tagha_loop_io_now(call->op, call->fd, call->iov.iov_base, call->iov.iov_len, call->offset);
+	}
+	_tagha_loop_ready(loop, call);
+}
+
+/// the loop call the native runs for, NULL if its script can't be suspended on a loop.
+static NO_NULL struct TaghaLoopCall *_tagha_loop_suspend(struct TaghaModule *const ctxt)
+{
+	struct TaghaLoopCall *const call = _loop_call;
+	return ( call != NULL && call->module==ctxt && tagha_module_suspend(ctxt) ) ? call : NULL;
+}
+
+/// returns whether the call finished.
+static NO_NULL bool _tagha_loop_step(struct TaghaLoop *const restrict loop, struct TaghaLoopCall *const restrict call)
+{
+	struct TaghaModule *const module = call->module;
+	if( !call->started && tagha_module_suspended(module) ) {
+		/// the suspended call belongs to someone else, resuming it from here would take its result.
+		loop->live--;
+		if( call->on_done != NULL )
+			(*call->on_done)(call->data, module, TaghaErrSuspended, ( union TaghaVal ){ 0 });
+		free(call);
+		return true;
+	}
+	
+	struct TaghaLoopCall *const outer = _loop_call;
+	const int op = call->op;
+	call->op = TaghaLoopOpNone;
+	_loop_call = call;
+	if( !call->started ) {
+		call->started = true;
+		module->err = TaghaErrNone;
+		tagha_module_invoke(module, call->func, call->args, call->params, &call->result);
+	} else if( op != TaghaLoopOpNone ) {
+		tagha_module_resume_with(module, call->io_result, &call->result);
+	} else {
+		tagha_module_resume(module, &call->result);
+	}
+	_loop_call = outer;
+	
+	if( tagha_module_suspended(module) ) {
+		/// yields & natives suspending the script on their own are resumed on the next turn.
+		if( call->op==TaghaLoopOpNone )
+			_tagha_loop_ready(loop, call);
+		return false;
+	}
+	
+	loop->live--;
+	if( call->on_done != NULL )
+		(*call->on_done)(call->data, module, module->err, call->result);
+	free(call);
+	return true;
+}
+
+
+TAGHA_EXPORT bool tagha_loop_init(struct TaghaLoop *const loop, const uint32_t entries, const uint32_t flags)
+{
+	*loop = (struct TaghaLoop){ .fd = -1 };
+	if( !(flags & TAGHA_LOOP_EPOLL) && _tagha_uring_init(loop, ( entries > 0 ) ? entries : 256) )
+		return true;
+	
+	loop->fd = epoll_create1(EPOLL_CLOEXEC);
+	return loop->fd >= 0;
+}
+
+TAGHA_EXPORT void tagha_loop_clear(struct TaghaLoop *const loop)
+{
+	while( loop->ready != NULL ) {
+		struct TaghaLoopCall *const next = loop->ready->next;
+		free(loop->ready);
+		loop->ready = next;
+	}
+	if( loop->uring ) {
+		struct TaghaLoopRing *const ring = &loop->ring;
+		munmap(ring->sqes, ring->sqes_len);
+		if( ring->cq_map != ring->sq_map )
+			munmap(ring->cq_map, ring->cq_map_len);
+		munmap(ring->sq_map, ring->sq_map_len);
+	}
+	if( loop->fd >= 0 )
+		close(loop->fd);
+	free(loop->timers);
+	*loop = (struct TaghaLoop){ .fd = -1 };
+}
+
+TAGHA_EXPORT bool tagha_loop_spawn(struct TaghaLoop *const loop, struct TaghaModule *const module, const TaghaFunc func, const size_t args, const union TaghaVal params[const], TaghaTaskCallback *const on_done, void *const data)
+{
+	struct TaghaLoopCall *const call = calloc(1, sizeof *call + sizeof *params * args);
+	if( call==NULL )
+		return false;
+	
+	call->loop    = loop;
+	call->module  = module;
+	call->func    = func;
+	call->on_done = on_done;
+	call->data    = data;
+	call->args    = args;
+	if( args > 0 )
+		memcpy(call->params, params, sizeof *params * args);
+	loop->live++;
+	_tagha_loop_ready(loop, call);
+	return true;
+}
+
+TAGHA_EXPORT size_t tagha_loop_run(struct TaghaLoop *const loop)
+{
+	size_t finished = 0;
+	while( loop->live > 0 ) {
+		/// calls readied during this turn wait for the next.
+		struct TaghaLoopCall *call = loop->ready;
+		loop->ready = loop->ready_tail = NULL;
+		while( call != NULL ) {
+			struct TaghaLoopCall *const next = call->next;
+			finished += _tagha_loop_step(loop, call);
+			call = next;
+		}
+		if( loop->live==0 )
+			break;
+		
+		const bool wait = loop->ready==NULL;
+		if( loop->uring ) {
+			_tagha_uring_enter(loop, wait);
+			_tagha_uring_reap(loop);
+		} else {
+			_tagha_epoll_wait(loop, wait);
+		}
+	}
+	return finished;
+}
+
+#else
+
+TAGHA_EXPORT bool tagha_loop_init(struct TaghaLoop *const loop, const uint32_t entries, const uint32_t flags)
+{
+	( void )entries; ( void )flags;
+	*loop = (struct TaghaLoop){ .fd = -1 };
+	return false;
+}
+
+TAGHA_EXPORT void tagha_loop_clear(struct TaghaLoop *const loop)
+{
+	*loop = (struct TaghaLoop){ .fd = -1 };
+}
+
+TAGHA_EXPORT bool tagha_loop_spawn(struct TaghaLoop *const loop, struct TaghaModule *const module, const TaghaFunc func, const size_t args, const union TaghaVal params[const], TaghaTaskCallback *const on_done, void *const data)
+{
+	( void )loop; ( void )module; ( void )func; ( void )args; ( void )params; ( void )on_done; ( void )data;
+	return false;
+}
+
+TAGHA_EXPORT size_t tagha_loop_run(struct TaghaLoop *const loop)
+{
+	( void )loop;
+	return 0;
+}
+
+#endif
+
+
+#ifndef OS_WINDOWS
+static union TaghaVal _tagha_loop_native_io(struct TaghaModule *const ctxt, const int op, const union TaghaVal params[const static 4])
+{
+	const int fd = params[0].int32;
+	void *const buf = ( void* )params[1].uintptr;
+	const size_t len = params[2].size;
+	const int64_t offset = params[3].int64;
+#	ifdef __linux__
+	struct TaghaLoopCall *const call = _tagha_loop_suspend(ctxt);
+	if( call != NULL ) {
+		call->op     = op;
+		call->fd     = fd;
+		call->iov    = (struct iovec){ .iov_base = buf, .iov_len = len };
+		call->offset = offset;
+		_tagha_loop_submit(call->loop, call);
+		return ( union TaghaVal ){ 0 };
+	}
+#	else
+	( void )ctxt;
+#	endif
+	return ( union TaghaVal ){ .int64 = _tagha_loop_io_now(op, fd, buf, len, offset) };
+}
+
+/// ssize_t io_read(int fd, void *buf, size_t len, int64_t offset); a negative offset reads at the file's position.
+static union TaghaVal _tagha_native_io_read(struct TaghaModule *const ctxt, const union TaghaVal params[const static 4])
+{
+	return _tagha_loop_native_io(ctxt, TaghaLoopOpRead, params);
+}
+
+/// ssize_t io_write(int fd, const void *buf, size_t len, int64_t offset);
+static union TaghaVal _tagha_native_io_write(struct TaghaModule *const ctxt, const union TaghaVal params[const static 4])
+{
+	return _tagha_loop_native_io(ctxt, TaghaLoopOpWrite, params);
+}
+
+/// void io_sleep(uint64_t ms);
+static union TaghaVal _tagha_native_io_sleep(struct TaghaModule *const ctxt, const union TaghaVal params[const static 1])
+{
+	const uint64_t ns = params[0].uint64 * 1000000u;
+#	ifdef __linux__
+	struct TaghaLoopCall *const call = _tagha_loop_suspend(ctxt);
+	if( call != NULL ) {
+		call->op = TaghaLoopOpSleep;
+		call->ts = (struct __kernel_timespec){ .tv_sec = ( int64_t )(ns / 1000000000u), .tv_nsec = ( long long )(ns % 1000000000u) };
+		_tagha_loop_submit(call->loop, call);
+		return ( union TaghaVal ){ 0 };
+	}
+#	else
+	( void )ctxt;
+#	endif
+	_tagha_loop_sleep_now(ns);
+	return ( union TaghaVal ){ 0 };
+}
+#endif
+
+TAGHA_EXPORT const struct TaghaNative tagha_loop_natives[] = {
+#ifndef OS_WINDOWS
+	{"io_read",  &_tagha_native_io_read},
+	{"io_write", &_tagha_native_io_write},
+	{"io_sleep", &_tagha_native_io_sleep},
+#endif
+	{ NULL, NULL }
+};
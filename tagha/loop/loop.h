@@ -0,0 +1,62 @@
+#ifndef TAGHA_LOOP_INCLUDED
+#	define TAGHA_LOOP_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../tagha.h"
+
+
+/**
+ * Event loop for suspended calls, Linux only.
+ * natives from `tagha_loop_natives` suspend their script while its file, pipe or timer operation runs,
+ * the loop resumes the script with the operation's result once it completes.
+ * operations go through io_uring where the kernel has it, otherwise epoll waits on pipes & sockets
+ * while regular files, which are always ready, are read & written in place.
+ * a loop runs its calls on whichever thread calls `tagha_loop_run`.
+ */
+enum {
+	TAGHA_LOOP_EPOLL = 1 << 0, /// skips io_uring even where the kernel has it.
+};
+
+struct TaghaLoopCall;
+
+/// io_uring's rings, shared with the kernel.
+struct TaghaLoopRing {
+	volatile uint32_t *sq_head, *sq_tail, *sq_array, *cq_head, *cq_tail;
+	uint32_t sq_mask, cq_mask, sq_entries, unsubmitted;
+	void    *sqes, *cqes, *sq_map, *cq_map;
+	size_t   sq_map_len, cq_map_len, sqes_len;
+};
+
+struct TaghaLoop {
+	struct TaghaLoopRing  ring;
+	struct TaghaLoopCall *ready, *ready_tail; /// calls to start or resume on the next turn, in order.
+	struct TaghaLoopCall **timers;            /// sleeping calls under epoll, a min-heap on their deadline.
+	size_t timers_len, timers_cap;
+	size_t live;   /// calls spawned & not finished yet.
+	int    fd;     /// io_uring or epoll instance.
+	bool   uring;
+};
+
+/// 'entries' is io_uring's queue depth, 0 picks one. false if neither io_uring nor epoll are available.
+TAGHA_EXPORT NO_NULL bool tagha_loop_init(struct TaghaLoop *loop, uint32_t entries, uint32_t flags);
+/// calls that were never run are dropped, suspended ones have to be run to their end first.
+TAGHA_EXPORT NO_NULL void tagha_loop_clear(struct TaghaLoop *loop);
+
+/// queues a call of 'func' on 'module', it starts on the loop's next turn. 'on_done' can be NULL.
+/// a module runs one loop call at a time, a call starting while another is suspended on it finishes right away with `TaghaErrSuspended`.
+TAGHA_EXPORT NEVER_NULL(1,2,3) bool tagha_loop_spawn(struct TaghaLoop *loop, struct TaghaModule *module, TaghaFunc func, size_t args, const union TaghaVal params[], TaghaTaskCallback *on_done, void *data);
+/// runs calls until every one of them finished, returns how many did.
+TAGHA_EXPORT NO_NULL size_t tagha_loop_run(struct TaghaLoop *loop);
+
+/// `io_read`, `io_write` & `io_sleep` natives for scripts, they block in place outside of a loop.
+TAGHA_EXPORT extern const struct TaghaNative tagha_loop_natives[];
+/********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TAGHA_LOOP_INCLUDED */
@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <stddef.h>
 
 #ifdef OS_WINDOWS
 #	define TAGHA_LIB
@@ -16,59 +17,207 @@ static NO_NULL struct TaghaItem *_tagha_key_get_item(const struct TaghaSymTable
 	if( syms->len==0 )
 		return NULL;
 	else {
-		const size_t hash = string_hash(key);
-		const size_t index = hash % TAGHA_SYM_BUCKETS;
-		for( size_t i=syms->buckets[index]; i != SIZE_MAX; i = syms->chain[i] ) {
-			if( syms->hashes[i]==hash || !strcmp(syms->keys[i], key) ) {
-				return syms->table + i;
-			}
+		const uint32_t hash = tagha_sym_hash(key);
+		/// load factor is at most 1/2, so there's always an empty slot to stop at.
+		for( size_t i = hash & syms->mask;; i = (i + 1) & syms->mask ) {
+			const struct TaghaSymSlot slot = syms->slots[i];
+			if( slot.index==UINT32_MAX )
+				return NULL;
+			else if( slot.hash==hash && !strcmp(syms->keys[slot.index], key) )
+				return syms->table + slot.index;
 		}
-		return NULL;
 	}
 }
 
 
-static NO_NULL bool _setup_memory(struct TaghaModule *const module)
+static NO_NULL uint32_t _tagha_module_hdr_version(const struct TaghaModuleHeader *const hdr)
+{
+	/// legacy modules have no version field, their func table starts where it would be.
+	return( hdr->funcs_offset > offsetof(struct TaghaModuleHeader, version) ) ? hdr->version : TAGHA_MODULE_VERSION_LEGACY;
+}
+
+/// slack past the heap's end, the memory checks let the last byte of the operand stack be read as a whole `union TaghaVal`.
+#define TAGHA_HEAP_TAIL    sizeof(union TaghaVal)
+
+/// makes freshly committed pages of the memory region resident as the load flags ask.
+static NO_NULL void _tagha_module_settle_pages(struct TaghaModule *const module, uint8_t *const pages, const size_t size)
+{
+	const uint32_t flags = module->heap_range.load_flags;
+	if( flags & TAGHA_LOAD_PREFAULT )
+		harbol_vmem_prefault(pages, size);
+	if( flags & TAGHA_LOAD_MLOCK && !harbol_vmem_lock(pages, size) ) {
+		fprintf(stderr, "Tagha Module Warning :: **** Unable to lock memory region of size (%zu), check RLIMIT_MEMLOCK. ****\n", size);
+		module->heap_range.load_flags &= ~TAGHA_LOAD_MLOCK;
+	}
+}
+
+/// reserves room for the heap to grow up to its limit, only what the header asks for gets committed.
+static NO_NULL uint8_t *_setup_heap_range(struct TaghaModule *const module, const size_t data_size, const size_t limit_size, const uint32_t flags)
+{
+	const size_t page = harbol_vmem_page_size();
+	const size_t committed = harbol_align_size(data_size + TAGHA_HEAP_TAIL, page);
+	size_t reserved = harbol_align_size(limit_size + TAGHA_HEAP_TAIL, page);
+	uint8_t *data = NULL;
+	module->heap_range.load_flags = flags;
+	if( flags & TAGHA_LOAD_HUGE_PAGES ) {
+		reserved = harbol_align_size(reserved, HARBOL_VMEM_HUGE_PAGE_SIZE);
+		/// explicit huge pages can't be committed piecemeal, only fixed size regions get them.
+		if( limit_size==data_size && (data = harbol_vmem_map_huge(reserved)) != NULL ) {
+			module->heap_range.reserved  = reserved;
+			module->heap_range.committed = reserved;
+			_tagha_module_settle_pages(module, data, reserved);
+			return data;
+		}
+		data = harbol_vmem_reserve_aligned(reserved, HARBOL_VMEM_HUGE_PAGE_SIZE);
+		if( data != NULL )
+			harbol_vmem_advise_huge(data, reserved);
+	} else {
+		data = harbol_vmem_reserve(reserved);
+	}
+	
+	if( data==NULL )
+		return NULL;
+	else if( !harbol_vmem_commit(data, committed) ) {
+		harbol_vmem_release(data, reserved);
+		return NULL;
+	}
+	module->heap_range.reserved  = reserved;
+	module->heap_range.committed = committed;
+	_tagha_module_settle_pages(module, data, committed);
+	return data;
+}
+
+static NO_NULL bool _setup_memory(struct TaghaModule *const restrict module, const struct TaghaModuleOpts *const restrict opts)
 {
 	const struct TaghaModuleHeader *const hdr = ( const struct TaghaModuleHeader* )module->script;
-	module->heap = harbol_mempool_from_buffer(( uint8_t* )(module->script + hdr->mem_offset), hdr->memsize);
-	const size_t given_heapsize = harbol_mempool_mem_remaining(&module->heap);
-	if( given_heapsize != hdr->memsize ) {
-		fprintf(stderr, "Tagha Module File Error :: **** given heapsize (%zu) is not same as required memory size! (%u). ****\n", given_heapsize, hdr->memsize);
+	uint8_t *mem_region = NULL;
+	size_t mem_region_size = hdr->memsize;
+	bool growable = false;
+	if( _tagha_module_hdr_version(hdr)==TAGHA_MODULE_VERSION_LEGACY ) {
+		/// legacy modules carry their zeroed mem region right after the var table.
+		module->flags &= ~TAGHA_MODULE_HEAP_ALLOCATOR;
+		module->low_seg = module->script + hdr->vars_offset;
+		mem_region = ( uint8_t* )(module->script + hdr->mem_offset);
+	} else {
+		/// TLSF keeps its bins inside the region, give them room on top of what the script asked for.
+		if( module->flags & TAGHA_MODULE_HEAP_TLSF ) {
+			mem_region_size += HARBOL_TLSF_OVERHEAD;
+			module->flags &= ~TAGHA_MODULE_HEAP_ARENA;
+		} else if( opts->flags & TAGHA_LOAD_CONCURRENT_HEAP ) {
+			/// slabs & arenas have no locking, threads go straight to the shared mempool.
+			module->flags &= ~(TAGHA_MODULE_HEAP_SLAB | TAGHA_MODULE_HEAP_ARENA);
+		}
+		
+		/// var table + mem region have to be one segment for the memory safety checks.
+		const size_t vars_size = hdr->mem_offset - hdr->vars_offset;
+		const size_t aligned_vars_size = harbol_align_size(vars_size, sizeof(union TaghaVal));
+		growable = !(module->flags & TAGHA_MODULE_HEAP_TLSF) && opts->heap_limit > mem_region_size;
+		/// a growable heap's end is where the next block goes.
+		if( growable )
+			mem_region_size = harbol_align_size(mem_region_size, sizeof(uintptr_t));
+		const size_t data_size = aligned_vars_size + mem_region_size;
+		uint8_t *const restrict data = growable ?
+				_setup_heap_range(module, data_size, aligned_vars_size + opts->heap_limit, opts->flags)
+				: opts->flags != 0 ?
+					_setup_heap_range(module, data_size, data_size, opts->flags)
+					: calloc(data_size, sizeof *data);
+		if( data==NULL ) {
+			fprintf(stderr, "Tagha Module File Error :: **** Unable to allocate memory region of size (%u). ****\n", hdr->memsize);
+			return false;
+		}
+		memcpy(data, ( const uint8_t* )(module->script + hdr->vars_offset), vars_size);
+		module->data = ( uintptr_t )data;
+		module->low_seg = module->data;
+		mem_region = data + aligned_vars_size;
+	}
+	
+	size_t given_heapsize = 0;
+	if( module->flags & TAGHA_MODULE_HEAP_TLSF ) {
+		module->tlsf = harbol_tlsf_from_buffer(mem_region, mem_region_size);
+		given_heapsize = harbol_tlsf_mem_remaining(&module->tlsf);
+	} else {
+		module->heap = harbol_mempool_from_buffer(mem_region, mem_region_size);
+		given_heapsize = harbol_mempool_mem_remaining(&module->heap);
+		if( module->heap_range.reserved != 0 ) {
+			/// dropping pages would undo prefaulting, fails on locked pages & splits huge pages.
+			if( !(module->heap_range.load_flags & (TAGHA_LOAD_HUGE_PAGES | TAGHA_LOAD_PREFAULT | TAGHA_LOAD_MLOCK)) )
+				module->heap.page_zero_min = TAGHA_HEAP_PAGE_ZERO;
+			module->heap_range.min_size = mem_region_size;
+			module->heap_range.limit    = growable ? opts->heap_limit & -sizeof(uintptr_t) : mem_region_size;
+		}
+	}
+	
+	if( given_heapsize < hdr->memsize ) {
+		fprintf(stderr, "Tagha Module File Error :: **** given heapsize (%zu) is less than required memory size! (%u). ****\n", given_heapsize, hdr->memsize);
 		return false;
 	} else {
 		module->callstack_size = hdr->callstacksize;
 		module->opstack_size = hdr->opstacksize;
 		
-		module->opstack = tagha_module_heap_alloc(module, hdr->opstacksize);
+		/// stacks come straight from the backing allocator, the opstack has to be the topmost block.
+		const bool tlsf = module->flags & TAGHA_MODULE_HEAP_TLSF;
+		module->opstack = ( uintptr_t )(tlsf ? harbol_tlsf_alloc(&module->tlsf, hdr->opstacksize) : harbol_mempool_alloc(&module->heap, hdr->opstacksize));
 		module->osp = module->opstack + module->opstack_size;
 		
 		module->high_seg = module->opstack + module->opstack_size + 1;
-		module->callstack = tagha_module_heap_alloc(module, hdr->callstacksize);
+		module->callstack = ( uintptr_t )(tlsf ? harbol_tlsf_alloc(&module->tlsf, hdr->callstacksize) : harbol_mempool_alloc(&module->heap, hdr->callstacksize));
 		module->csp = module->callstack; 
+		if( module->opstack==NIL || module->callstack==NIL ) {
+			fputs("Tagha Module File Error :: **** Unable to allocate the operand & call stacks. ****\n", stderr);
+			return false;
+		}
+		
+		if( module->flags & TAGHA_MODULE_HEAP_SLAB )
+			module->slabs = harbol_slab_create(&module->heap);
+		else if( !tlsf && opts->flags & TAGHA_LOAD_CONCURRENT_HEAP && !harbol_mempool_share(&module->heap) ) {
+			fputs("Tagha Module File Error :: **** Unable to share the heap between threads. ****\n", stderr);
+			return false;
+		}
 		return true;
 	}
 }
 
+/// modules before version 4 don't carry a usable symbol index, hash the keys on load.
+static NO_NULL bool _build_sym_index(struct TaghaModule *const restrict module, struct TaghaSymTable *const restrict syms)
+{
+	const uint32_t slot_count = tagha_sym_slot_count(( uint32_t )syms->len);
+	struct TaghaSymSlot *const restrict slots = ( struct TaghaSymSlot* )tagha_module_heap_alloc(module, sizeof *slots * slot_count);
+	if( slots==NULL )
+		return false;
+	
+	for( size_t i=0; i<slot_count; i++ )
+		slots[i].index = UINT32_MAX;
+	
+	syms->mask = slot_count - 1;
+	/// insert in table order so the first of any duplicate keys is found first.
+	for( size_t i=0; i<syms->len; i++ ) {
+		const uint32_t hash = tagha_sym_hash(syms->keys[i]);
+		size_t n = hash & syms->mask;
+		while( slots[n].index != UINT32_MAX )
+			n = (n + 1) & syms->mask;
+		slots[n] = (struct TaghaSymSlot){ hash, ( uint32_t )i };
+	}
+	syms->slots = slots;
+	return true;
+}
+
+static NO_NULL void _use_sym_index(struct TaghaSymTable *const restrict syms, const struct TaghaSymSlot *const restrict index)
+{
+	syms->slots = index;
+	syms->mask  = tagha_sym_slot_count(( uint32_t )syms->len) - 1;
+}
+
 static NO_NULL bool _setup_func_table(struct TaghaModule *const module)
 {
 	const struct TaghaModuleHeader *const hdr = ( const struct TaghaModuleHeader* )module->script;
-	struct TaghaSymTable *const funcs = harbol_mempool_alloc(&module->heap, sizeof *funcs);
+	struct TaghaSymTable *const funcs = ( struct TaghaSymTable* )tagha_module_heap_alloc(module, sizeof *funcs);
 	if( funcs==NULL ) {
 		fputs("Tagha Module File Error :: **** Unable to allocate function symbol table. ****\n", stderr);
 		return false;
 	}
 	funcs->len    = hdr->func_count;
-	funcs->table  = harbol_mempool_alloc(&module->heap, sizeof *funcs->table  * funcs->len);
-	funcs->keys   = harbol_mempool_alloc(&module->heap, sizeof *funcs->keys   * funcs->len);
-	funcs->hashes = harbol_mempool_alloc(&module->heap, sizeof *funcs->hashes * funcs->len);
-	
-	for( size_t i=0; i<TAGHA_SYM_BUCKETS; i++ )
-		funcs->buckets[i] = SIZE_MAX;
-	
-	funcs->chain = harbol_mempool_alloc(&module->heap, sizeof *funcs->chain   * funcs->len);
-	for( uint32_t i=0; i<funcs->len; i++ )
-		funcs->chain[i] = SIZE_MAX;
+	funcs->table  = ( struct TaghaItem* )tagha_module_heap_alloc(module, sizeof *funcs->table * funcs->len);
+	funcs->keys   = ( const char** )tagha_module_heap_alloc(module, sizeof *funcs->keys  * funcs->len);
 	
 	union HarbolBinIter iter = { .uint8 = ( uint8_t* )(module->script + hdr->funcs_offset) };
 	for( uint32_t i=0; i<hdr->func_count; i++ ) {
@@ -76,7 +225,6 @@ static NO_NULL bool _setup_func_table(struct TaghaModule *const module)
 		iter.uint8 += sizeof *entry;
 		const uint32_t flag = entry->flags;
 		const char *cstr = iter.string;
-		const size_t hash = string_hash(cstr);
 		iter.uint8 += entry->name_len;
 		const struct TaghaItem funcitem = {
 			.owner = flag & TAGHA_FLAG_EXTERN ? NIL : ( uintptr_t )module,
@@ -85,54 +233,41 @@ static NO_NULL bool _setup_func_table(struct TaghaModule *const module)
 			.item  = (!flag) ? ( uintptr_t )iter.uint8 : NIL
 		};
 		
-		funcs->table[i]  = funcitem;
-		funcs->keys[i]   = cstr;
-		funcs->hashes[i] = hash;
-		
-		if( funcs->buckets[hash % TAGHA_SYM_BUCKETS] == SIZE_MAX ) {
-			funcs->buckets[hash % TAGHA_SYM_BUCKETS] = i;
-		} else {
-			size_t n = funcs->buckets[hash % TAGHA_SYM_BUCKETS];
-			while( funcs->chain[n] != SIZE_MAX )
-				n = funcs->chain[n];
-			funcs->chain[n] = i;
-		}
+		funcs->table[i] = funcitem;
+		funcs->keys[i]  = cstr;
 		
 		if( !flag )
 			iter.uint8 += entry->data_len;
 	}
-	module->funcs = funcs;
+	
+	if( _tagha_module_hdr_version(hdr) >= TAGHA_MODULE_VERSION ) {
+		_use_sym_index(funcs, ( const struct TaghaSymSlot* )(module->script + hdr->index_offset));
+	} else if( !_build_sym_index(module, funcs) ) {
+		fputs("Tagha Module File Error :: **** Unable to allocate function symbol index. ****\n", stderr);
+		return false;
+	}
+	module->funcs = module->own_funcs = funcs;
 	return true;
 }
 
 static NO_NULL bool _setup_var_table(struct TaghaModule *const module)
 {
 	const struct TaghaModuleHeader *const hdr = ( const struct TaghaModuleHeader* )module->script;
-	struct TaghaSymTable *const vars = harbol_mempool_alloc(&module->heap, sizeof *vars);
+	struct TaghaSymTable *const vars = ( struct TaghaSymTable* )tagha_module_heap_alloc(module, sizeof *vars);
 	if( vars==NULL ) {
 		fputs("Tagha Module File Error :: **** Unable to allocate global var symbol table. ****\n", stderr);
 		return false;
 	}
 	vars->len    = hdr->var_count;
-	vars->table  = harbol_mempool_alloc(&module->heap, sizeof *vars->table  * vars->len);
-	vars->keys   = harbol_mempool_alloc(&module->heap, sizeof *vars->keys   * vars->len);
-	vars->hashes = harbol_mempool_alloc(&module->heap, sizeof *vars->hashes * vars->len);
-	
-	for( size_t i=0; i<TAGHA_SYM_BUCKETS; i++ )
-		vars->buckets[i] = SIZE_MAX;
-	
-	vars->chain = harbol_mempool_alloc(&module->heap, sizeof *vars->chain   * vars->len);
-	for( size_t i=0; i<vars->len; i++ )
-		vars->chain[i] = SIZE_MAX;
+	vars->table  = ( struct TaghaItem* )tagha_module_heap_alloc(module, sizeof *vars->table * vars->len);
+	vars->keys   = ( const char** )tagha_module_heap_alloc(module, sizeof *vars->keys  * vars->len);
 	
-	union HarbolBinIter iter = { .uint8 = ( uint8_t* )(module->script + hdr->vars_offset) };
-	module->low_seg = ( uintptr_t )iter.uint8;
+	union HarbolBinIter iter = { .uint8 = ( uint8_t* )module->low_seg };
 	for( uint32_t i=0; i<hdr->var_count; i++ ) {
 		const struct TaghaItemEntry *const entry = iter.ptr;
 		iter.uint8 += sizeof *entry;
 		const uint32_t flag = entry->flags;
 		const char *cstr = iter.string;
-		const size_t hash = string_hash(cstr);
 		iter.uint8 += entry->name_len;
 		const struct TaghaItem varitem = {
 			.owner = flag & TAGHA_FLAG_EXTERN ? NIL : ( uintptr_t )module,
@@ -140,39 +275,52 @@ static NO_NULL bool _setup_var_table(struct TaghaModule *const module)
 			.flags = flag,
 			.item  = ( uintptr_t )iter.uint8
 		};
-		vars->table[i]  = varitem;
-		vars->keys[i]   = cstr;
-		vars->hashes[i] = hash;
-		
-		if( vars->buckets[hash % TAGHA_SYM_BUCKETS] == SIZE_MAX ) {
-			vars->buckets[hash % TAGHA_SYM_BUCKETS] = i;
-		} else {
-			size_t n = vars->buckets[hash % TAGHA_SYM_BUCKETS];
-			while( vars->chain[n] != SIZE_MAX )
-				n = vars->chain[n];
-			vars->chain[n] = i;
-		}
+		vars->table[i] = varitem;
+		vars->keys[i]  = cstr;
 		
 		iter.uint8 += entry->data_len;
 	}
-	module->vars = vars;
+	
+	if( _tagha_module_hdr_version(hdr) >= TAGHA_MODULE_VERSION ) {
+		/// var index follows the func index.
+		const struct TaghaSymSlot *const func_index = ( const struct TaghaSymSlot* )(module->script + hdr->index_offset);
+		_use_sym_index(vars, func_index + module->funcs->mask + 1);
+	} else if( !_build_sym_index(module, vars) ) {
+		fputs("Tagha Module File Error :: **** Unable to allocate global var symbol index. ****\n", stderr);
+		return false;
+	}
+	module->vars = module->own_vars = vars;
 	return true;
 }
 
-static NO_NULL bool _read_module_data(struct TaghaModule *const restrict module, const uintptr_t filedata)
+static NO_NULL bool _read_module_data(struct TaghaModule *const restrict module, const uintptr_t filedata, const struct TaghaModuleOpts *const restrict opts)
 {
 	module->script = filedata;
 	const struct TaghaModuleHeader *const hdr = ( const struct TaghaModuleHeader* )filedata;
 	module->flags = hdr->flags;
 	
-	const bool res_mem   = _setup_memory(module);
-	const bool res_funcs = _setup_func_table(module);
-	const bool res_vars  = _setup_var_table(module);
-	return res_mem && res_funcs && res_vars;
+	/// var table lives in the data segment set up with the memory.
+	if( !_setup_memory(module, opts) || !_setup_func_table(module) || !_setup_var_table(module) )
+		return false;
+	
+	/// everything carved out so far has to survive a heap reset.
+	if( !(module->flags & TAGHA_MODULE_HEAP_TLSF) )
+		module->heap_mark = module->heap.stack.offs;
+	return true;
 }
 
 
 TAGHA_EXPORT struct TaghaModule *tagha_module_new_from_file(const char filename[restrict static 1])
+{
+	return tagha_module_new_from_file_opts(filename, &( const struct TaghaModuleOpts ){ 0 });
+}
+
+TAGHA_EXPORT struct TaghaModule *tagha_module_new_from_buffer(uint8_t buffer[restrict static 1])
+{
+	return tagha_module_new_from_buffer_opts(buffer, &( const struct TaghaModuleOpts ){ 0 });
+}
+
+TAGHA_EXPORT struct TaghaModule *tagha_module_new_from_file_opts(const char filename[restrict static 1], const struct TaghaModuleOpts *const restrict opts)
 {
 	struct TaghaModule *module = calloc(1, sizeof *module);
 	if( module==NULL ) {
@@ -187,7 +335,7 @@ TAGHA_EXPORT struct TaghaModule *tagha_module_new_from_file(const char filename[
 			fprintf(stderr, "Tagha Module Error :: **** Invalid Tagha Module: '%s' ****\n", filename);
 			free(bytecode);
 			free(module), module = NULL;
-		} else if( !_read_module_data(module, ( uintptr_t )bytecode) ) {
+		} else if( !_read_module_data(module, ( uintptr_t )bytecode, opts) ) {
 			fprintf(stderr, "Tagha Module Error :: **** Couldn't allocate tables for file: '%s' ****\n", filename);
 			tagha_module_free(&module);
 		}
@@ -195,7 +343,7 @@ TAGHA_EXPORT struct TaghaModule *tagha_module_new_from_file(const char filename[
 	return module;
 }
 
-TAGHA_EXPORT struct TaghaModule *tagha_module_new_from_buffer(uint8_t buffer[restrict static 1])
+TAGHA_EXPORT struct TaghaModule *tagha_module_new_from_buffer_opts(uint8_t buffer[restrict static 1], const struct TaghaModuleOpts *const restrict opts)
 {
 	struct TaghaModule *module = calloc(1, sizeof *module);
 	if( module==NULL ) {
@@ -205,7 +353,7 @@ TAGHA_EXPORT struct TaghaModule *tagha_module_new_from_buffer(uint8_t buffer[res
 		if( *( const uint32_t* )buffer != TAGHA_MAGIC_VERIFIER ) {
 			fprintf(stderr, "Tagha Module Error :: **** Invalid Tagha Module Buffer '%p' ****\n", buffer);
 			tagha_module_free(&module);
-		} else if( !_read_module_data(module, ( uintptr_t )buffer) ) {
+		} else if( !_read_module_data(module, ( uintptr_t )buffer, opts) ) {
 			fputs("Tagha Module Error :: **** Couldn't allocate tables from buffer ****\n", stderr);
 			tagha_module_free(&module);
 		}
@@ -220,6 +368,13 @@ TAGHA_EXPORT bool tagha_module_clear(struct TaghaModule *const restrict module)
 		uint8_t *const restrict script = ( uint8_t* )module->script;
 		free(script);
 	}
+	harbol_mempool_unshare(&module->heap);
+	if( module->data != NIL ) {
+		uint8_t *const restrict data = ( uint8_t* )module->data;
+		if( module->heap_range.reserved != 0 )
+			harbol_vmem_release(data, module->heap_range.reserved);
+		else free(data);
+	}
 	*module = (struct TaghaModule){0};
 	return true;
 }
@@ -251,14 +406,231 @@ TAGHA_EXPORT uint32_t tagha_module_get_flags(const struct TaghaModule *const mod
 	return module->flags;
 }
 
-TAGHA_EXPORT inline uintptr_t tagha_module_heap_alloc(struct TaghaModule *const module, const size_t size)
+/// thread contexts run on their module's heap.
+static inline NO_NULL struct TaghaModule *_tagha_module_root(struct TaghaModule *const module)
+{
+	return( module->parent != NULL ) ? module->parent : module;
+}
+
+/// only a module's outermost host call can be suspended, its thread contexts & scheduled calls run to their end.
+static inline NO_NULL bool _tagha_module_can_suspend(const struct TaghaModule *const module)
+{
+	return module->parent==NULL && module->call_depth==1 && harbol_atomic_load_size(( volatile size_t* )&module->queue.pending)==0;
+}
+
+static inline NO_NULL bool _tagha_module_in_scope(const struct TaghaModule *const module)
+{
+	return( module->flags & TAGHA_MODULE_HEAP_ARENA ) && module->call_depth > 0;
+}
+
+/// the memory checks cover up to the heap's end once it grew past the operand stack.
+static NO_NULL void _tagha_module_update_bounds(struct TaghaModule *const module)
+{
+	const uintptr_t heap_end = module->heap.stack.mem + module->heap.stack.size - 1;
+	const uintptr_t opstack_end = module->opstack + module->opstack_size + 1;
+	harbol_atomic_store_uintptr(&module->high_seg, ( heap_end > opstack_end ) ? heap_end : opstack_end);
+}
+
+/// commits more of the reserved range & hands it to the mempool, false once the limit is hit.
+static NO_NULL bool _tagha_module_heap_grow_locked(struct TaghaModule *const module, const size_t size)
+{
+	struct TaghaHeapRange *const range = &module->heap_range;
+	if( range->reserved==0 || module->heap.stack.size >= range->limit )
+		return false;
+	
+	const size_t page = harbol_vmem_page_size();
+	size_t grow = harbol_align_size(size + HARBOL_MEMNODE_MIN, page);
+	if( grow < TAGHA_HEAP_GROW_STEP )
+		grow = TAGHA_HEAP_GROW_STEP;
+	if( grow > range->limit - module->heap.stack.size )
+		grow = range->limit - module->heap.stack.size;
+	
+	const size_t new_end = module->heap.stack.mem + module->heap.stack.size + grow - module->data;
+	if( new_end + TAGHA_HEAP_TAIL > range->committed ) {
+		const size_t committed = harbol_align_size(new_end + TAGHA_HEAP_TAIL, page);
+		uint8_t *const pages = ( uint8_t* )module->data + range->committed;
+		if( !harbol_vmem_commit(pages, committed - range->committed) )
+			return false;
+		_tagha_module_settle_pages(module, pages, committed - range->committed);
+		range->committed = committed;
+	}
+	if( !harbol_mempool_grow(&module->heap, grow) )
+		return false;
+	
+	range->idle_calls = 0;
+	_tagha_module_update_bounds(module);
+	return true;
+}
+
+static NO_NULL bool _tagha_module_heap_grow(struct TaghaModule *const module, const size_t size)
+{
+	harbol_mempool_lock(&module->heap);
+	const bool grown = _tagha_module_heap_grow_locked(module, size);
+	harbol_mempool_unlock(&module->heap);
+	return grown;
+}
+
+static NO_NULL size_t _tagha_module_heap_trim_locked(struct TaghaModule *const module)
+{
+	struct TaghaHeapRange *const range = &module->heap_range;
+	range->idle_calls = 0;
+	harbol_mempool_shrink(&module->heap, module->heap.stack.size - range->min_size);
+	_tagha_module_update_bounds(module);
+	
+	const size_t page = harbol_vmem_page_size();
+	const size_t keep = harbol_align_size(module->heap.stack.mem + module->heap.stack.size - module->data + TAGHA_HEAP_TAIL, page);
+	if( keep >= range->committed )
+		return 0;
+	
+	const size_t released = range->committed - keep;
+	if( range->load_flags & TAGHA_LOAD_MLOCK )
+		harbol_vmem_unlock(( uint8_t* )module->data + keep, released);
+	if( !harbol_vmem_decommit(( uint8_t* )module->data + keep, released) )
+		return 0;
+	range->committed = keep;
+	return released;
+}
+
+TAGHA_EXPORT size_t tagha_module_heap_trim(struct TaghaModule *const ctxt)
+{
+	struct TaghaModule *const module = _tagha_module_root(ctxt);
+	/// running thread contexts hold bounds that can't shrink under them.
+	if( module->heap_range.reserved==0 || module->heap_range.limit <= module->heap_range.min_size || harbol_atomic_load_size(&module->workers) != 0 )
+		return 0;
+	
+	harbol_mempool_lock(&module->heap);
+	const size_t released = _tagha_module_heap_trim_locked(module);
+	harbol_mempool_unlock(&module->heap);
+	return released;
+}
+
+/// O(1) unless zeroing, drops every heap allocation made since the module was loaded.
+TAGHA_EXPORT bool tagha_module_heap_reset(struct TaghaModule *const ctxt, const bool zero)
+{
+	struct TaghaModule *const module = _tagha_module_root(ctxt);
+	/// scripts could still hold pointers into the heap mid-call.
+	if( module->call_depth != 0 || module->heap_mark==NIL || harbol_atomic_load_size(&module->workers) != 0 )
+		return false;
+	
+	struct HarbolCache *const cache = &module->heap.stack;
+	const size_t size = ( module->heap_range.reserved != 0 ) ? module->heap_range.min_size : cache->size;
+	if( zero ) {
+		memset(( void* )cache->offs, 0, module->heap_mark - cache->offs);
+		memset(( void* )(cache->mem + size), 0, cache->size - size);
+	}
+	if( !harbol_mempool_rewind(&module->heap, module->heap_mark, size) )
+		return false;
+	else if( module->flags & TAGHA_MODULE_HEAP_SLAB )
+		harbol_slab_reset(&module->slabs);
+	return true;
+}
+
+/// arena blocks count towards the mempool's peak like any other allocation.
+static NO_NULL uintptr_t _tagha_arena_track_peak(struct TaghaModule *const module, void *const ptr)
+{
+	const size_t in_use = harbol_mempool_mem_in_use(&module->heap);
+	if( in_use > module->heap.stats.peak_in_use )
+		module->heap.stats.peak_in_use = in_use;
+	return ( uintptr_t )ptr;
+}
+
+TAGHA_EXPORT inline uintptr_t tagha_module_heap_alloc(struct TaghaModule *const ctxt, const size_t size)
+{
+	struct TaghaModule *const module = _tagha_module_root(ctxt);
+	if( _tagha_module_in_scope(module) )
+		return _tagha_arena_track_peak(module, harbol_cache_arena_alloc(&module->heap.stack, size));
+	else return tagha_module_heap_alloc_persistent(module, size);
+}
+
+static NO_NULL uintptr_t _tagha_module_pool_alloc(struct TaghaModule *const module, const size_t size, const bool zero)
+{
+	if( module->flags & TAGHA_MODULE_HEAP_TLSF )
+		return ( uintptr_t )(zero ? harbol_tlsf_alloc(&module->tlsf, size) : harbol_tlsf_alloc_uninit(&module->tlsf, size));
+	
+	const bool slab = module->flags & TAGHA_MODULE_HEAP_SLAB;
+	uintptr_t mem = NIL;
+	do {
+		if( module->heap.shared != NULL )
+			mem = ( uintptr_t )harbol_mempool_shared_alloc(&module->heap, size, zero);
+		else if( zero )
+			mem = ( uintptr_t )(slab ? harbol_slab_alloc(&module->slabs, size) : harbol_mempool_alloc(&module->heap, size));
+		else mem = ( uintptr_t )(slab ? harbol_slab_alloc_uninit(&module->slabs, size) : harbol_mempool_alloc_uninit(&module->heap, size));
+	} while( mem==NIL && size != 0 && _tagha_module_heap_grow(module, size) );
+	return mem;
+}
+
+/// escape hatch for arena scopes, the memory outlives the call & has to be freed.
+TAGHA_EXPORT uintptr_t tagha_module_heap_alloc_persistent(struct TaghaModule *const ctxt, const size_t size)
+{
+	struct TaghaModule *const module = _tagha_module_root(ctxt);
+	return _tagha_module_pool_alloc(module, size, true);
+}
+
+/// for buffers that are filled right away, the memory isn't zeroed.
+TAGHA_EXPORT uintptr_t tagha_module_heap_alloc_uninit(struct TaghaModule *const ctxt, const size_t size)
+{
+	struct TaghaModule *const module = _tagha_module_root(ctxt);
+	if( _tagha_module_in_scope(module) )
+		return _tagha_arena_track_peak(module, harbol_cache_arena_alloc_uninit(&module->heap.stack, size));
+	else return _tagha_module_pool_alloc(module, size, false);
+}
+
+TAGHA_EXPORT uintptr_t tagha_module_heap_realloc(struct TaghaModule *const ctxt, const uintptr_t ptr, const size_t size)
+{
+	struct TaghaModule *const module = _tagha_module_root(ctxt);
+	/// arena blocks stay in the arena, NIL only allocates from it inside a scope.
+	const bool in_arena = ( ptr==NIL ) ? _tagha_module_in_scope(module) : harbol_cache_arena_owns(&module->heap.stack, ( const void* )ptr);
+	if( in_arena )
+		return _tagha_arena_track_peak(module, harbol_cache_arena_realloc(&module->heap.stack, ( void* )ptr, size));
+	else if( module->flags & TAGHA_MODULE_HEAP_TLSF )
+		return ( uintptr_t )harbol_tlsf_realloc(&module->tlsf, ( void* )ptr, size);
+	
+	uintptr_t mem = NIL;
+	do {
+		if( module->heap.shared != NULL )
+			mem = ( uintptr_t )harbol_mempool_shared_realloc(&module->heap, ( void* )ptr, size);
+		else mem = ( module->flags & TAGHA_MODULE_HEAP_SLAB ) ? ( uintptr_t )harbol_slab_realloc(&module->slabs, ( void* )ptr, size) : ( uintptr_t )harbol_mempool_realloc(&module->heap, ( void* )ptr, size);
+	} while( mem==NIL && size != 0 && _tagha_module_heap_grow(module, size) );
+	return mem;
+}
+
+TAGHA_EXPORT inline bool tagha_module_heap_free(struct TaghaModule *const ctxt, const uintptr_t ptr)
 {
-	return ( uintptr_t )harbol_mempool_alloc(&module->heap, size);
+	struct TaghaModule *const module = _tagha_module_root(ctxt);
+	if( module->flags & TAGHA_MODULE_HEAP_TLSF )
+		return harbol_tlsf_free(&module->tlsf, ( void* )ptr);
+	else if( harbol_cache_arena_owns(&module->heap.stack, ( const void* )ptr) )
+		return harbol_cache_arena_free(&module->heap.stack, ( void* )ptr);
+	else if( module->heap.shared != NULL )
+		return harbol_mempool_shared_free(&module->heap, ( void* )ptr);
+	else if( module->flags & TAGHA_MODULE_HEAP_SLAB )
+		return harbol_slab_free(&module->slabs, ( void* )ptr);
+	else return harbol_mempool_free(&module->heap, ( void* )ptr);
 }
 
-TAGHA_EXPORT inline bool tagha_module_heap_free(struct TaghaModule *const module, const uintptr_t ptr)
+TAGHA_EXPORT void tagha_module_heap_stats(const struct TaghaModule *const restrict ctxt, struct TaghaHeapStats *const restrict stats)
 {
-	return harbol_mempool_free(&module->heap, ( void* )ptr);
+	const struct TaghaModule *const module = ( ctxt->parent != NULL ) ? ctxt->parent : ctxt;
+	const struct HarbolAllocStats *counters = NULL;
+	if( module->flags & TAGHA_MODULE_HEAP_TLSF ) {
+		stats->capacity     = module->tlsf.end - module->tlsf.mem;
+		stats->in_use       = harbol_tlsf_mem_in_use(&module->tlsf);
+		stats->largest_free = harbol_tlsf_largest_free(&module->tlsf);
+		counters = &module->tlsf.stats;
+	} else {
+		/// slabs & blocks cached by threads count as allocated blocks of the mempool.
+		harbol_mempool_lock(&module->heap);
+		stats->capacity     = module->heap.stack.size;
+		stats->in_use       = harbol_mempool_mem_in_use(&module->heap);
+		stats->largest_free = harbol_mempool_largest_free(&module->heap);
+		harbol_mempool_unlock(&module->heap);
+		counters = &module->heap.stats;
+	}
+	stats->free          = stats->capacity - stats->in_use;
+	stats->peak_in_use   = counters->peak_in_use;
+	stats->fragmentation = ( stats->free==0 ) ? 0.0 : 1.0 - ( double )stats->largest_free / ( double )stats->free;
+	memcpy(stats->allocs, counters->allocs, sizeof stats->allocs);
+	memcpy(stats->frees,  counters->frees,  sizeof stats->frees);
 }
 
 
@@ -272,6 +644,8 @@ TAGHA_EXPORT const char *tagha_module_get_err(const struct TaghaModule *const re
 		case TaghaErrBadNative:   return "Missing Native";
 		case TaghaErrBadExtern:   return "Bad External Function";
 		case TaghaErrOpStackOF:   return "Stack Overflow";
+		case TaghaErrCallStackOF: return "Call Stack Overflow";
+		case TaghaErrSuspended:   return "Suspended";
 		default:                  return "User-Defined/Unknown Error";
 	}
 }
@@ -281,6 +655,143 @@ TAGHA_EXPORT inline void tagha_module_throw_err(struct TaghaModule *const module
 	module->err = err;
 }
 
+/// process-wide native registry, ids are indexes into `natives`.
+struct TaghaNativeRegistry {
+	struct TaghaNative  *natives;
+	struct TaghaSymSlot *slots;   /// name hash -> native id.
+	size_t len, cap, mask;
+};
+static struct TaghaNativeRegistry _tagha_natives;
+
+static NO_NULL uint32_t _tagha_native_find(const char name[restrict static 1], const uint32_t hash)
+{
+	if( _tagha_natives.len==0 )
+		return TAGHA_NATIVE_INVALID_ID;
+	
+	for( size_t i = hash & _tagha_natives.mask;; i = (i + 1) & _tagha_natives.mask ) {
+		const struct TaghaSymSlot slot = _tagha_natives.slots[i];
+		if( slot.index==UINT32_MAX )
+			return TAGHA_NATIVE_INVALID_ID;
+		else if( slot.hash==hash && !strcmp(_tagha_natives.natives[slot.index].name, name) )
+			return slot.index;
+	}
+}
+
+static NO_NULL void _tagha_sym_slot_insert(struct TaghaSymSlot slots[const static 1], const size_t mask, const uint32_t hash, const uint32_t id)
+{
+	size_t n = hash & mask;
+	while( slots[n].index != UINT32_MAX )
+		n = (n + 1) & mask;
+	slots[n] = (struct TaghaSymSlot){ hash, id };
+}
+
+static bool _tagha_native_registry_grow(void)
+{
+	const size_t new_cap = (_tagha_natives.cap==0) ? 64 : _tagha_natives.cap << 1;
+	struct TaghaNative *const natives = realloc(_tagha_natives.natives, sizeof *natives * new_cap);
+	if( natives==NULL )
+		return false;
+	_tagha_natives.natives = natives;
+	
+	const uint32_t slot_count = tagha_sym_slot_count(( uint32_t )new_cap);
+	struct TaghaSymSlot *const slots = malloc(sizeof *slots * slot_count);
+	if( slots==NULL )
+		return false;
+	
+	for( size_t i=0; i<slot_count; i++ )
+		slots[i].index = UINT32_MAX;
+	for( size_t i=0; i<_tagha_natives.len; i++ )
+		_tagha_sym_slot_insert(slots, slot_count - 1, tagha_sym_hash(natives[i].name), ( uint32_t )i);
+	
+	free(_tagha_natives.slots);
+	_tagha_natives.slots = slots;
+	_tagha_natives.mask  = slot_count - 1;
+	_tagha_natives.cap   = new_cap;
+	return true;
+}
+
+TAGHA_EXPORT uint32_t tagha_native_register(const char name[restrict static 1], TaghaCFunc *const cfunc)
+{
+	const uint32_t hash = tagha_sym_hash(name);
+	const uint32_t found = _tagha_native_find(name, hash);
+	if( found != TAGHA_NATIVE_INVALID_ID ) {
+		/// re-registering keeps the id.
+		_tagha_natives.natives[found].cfunc = cfunc;
+		return found;
+	} else if( _tagha_natives.len==_tagha_natives.cap && !_tagha_native_registry_grow() ) {
+		fprintf(stderr, "Tagha Native Registry Error :: **** Unable to grow registry for native '%s'. ****\n", name);
+		return TAGHA_NATIVE_INVALID_ID;
+	} else {
+		const uint32_t id = ( uint32_t )_tagha_natives.len++;
+		_tagha_natives.natives[id] = (struct TaghaNative){ name, cfunc };
+		_tagha_sym_slot_insert(_tagha_natives.slots, _tagha_natives.mask, hash, id);
+		return id;
+	}
+}
+
+TAGHA_EXPORT bool tagha_native_register_all(const struct TaghaNative natives[static 1])
+{
+	for( size_t i=0; natives[i].name != NULL && natives[i].cfunc != NULL; i++ )
+		if( tagha_native_register(natives[i].name, natives[i].cfunc)==TAGHA_NATIVE_INVALID_ID )
+			return false;
+	return true;
+}
+
+TAGHA_EXPORT uint32_t tagha_native_get_id(const char name[restrict static 1])
+{
+	return _tagha_native_find(name, tagha_sym_hash(name));
+}
+
+TAGHA_EXPORT TaghaCFunc *tagha_native_get(const uint32_t id)
+{
+	return( id < _tagha_natives.len ) ? _tagha_natives.natives[id].cfunc : NULL;
+}
+
+TAGHA_EXPORT void tagha_native_registry_clear(void)
+{
+	free(_tagha_natives.natives);
+	free(_tagha_natives.slots);
+	_tagha_natives = (struct TaghaNativeRegistry){0};
+}
+
+static NO_NULL bool _tagha_native_bind(struct TaghaItem *const restrict func, const char name[restrict static 1], const uint32_t hash)
+{
+	const uint32_t id = _tagha_native_find(name, hash);
+	if( id==TAGHA_NATIVE_INVALID_ID ) {
+		return false;
+	} else {
+		func->item  = ( uintptr_t )_tagha_natives.natives[id].cfunc;
+		func->flags = TAGHA_FLAG_NATIVE | TAGHA_FLAG_LINKED;
+		return true;
+	}
+}
+
+TAGHA_EXPORT bool tagha_module_link_registry(struct TaghaModule *const module)
+{
+	/// walk the slots so the precomputed hashes are reused.
+	const struct TaghaSymTable *const funcs = module->funcs;
+	bool all_linked = true;
+	for( size_t i=0; funcs->len > 0 && i <= funcs->mask; i++ ) {
+		const struct TaghaSymSlot slot = funcs->slots[i];
+		if( slot.index==UINT32_MAX || funcs->table[slot.index].flags != TAGHA_FLAG_NATIVE )
+			continue;
+		else if( !_tagha_native_bind(&funcs->table[slot.index], funcs->keys[slot.index], slot.hash) )
+			all_linked = false;
+	}
+	return all_linked;
+}
+
+/// binds an unlinked native import through the registry on its first call.
+static NO_NULL bool _tagha_native_lazy_link(const struct TaghaSymTable *const syms, const TaghaFunc f)
+{
+	if( f->flags != TAGHA_FLAG_NATIVE ) {
+		return false;
+	} else {
+		const char *const name = syms->keys[f - syms->table];
+		return _tagha_native_bind(( struct TaghaItem* )f, name, tagha_sym_hash(name));
+	}
+}
+
 TAGHA_EXPORT void tagha_module_link_natives(struct TaghaModule *const module, const struct TaghaNative natives[static 1])
 {
 	for( size_t i=0; natives[i].name != NULL && natives[i].cfunc != NULL; i++ ) {
@@ -334,54 +845,697 @@ TAGHA_EXPORT void tagha_module_link_module(struct TaghaModule *const restrict mo
 }
 
 
-TAGHA_EXPORT bool tagha_module_call(struct TaghaModule *const restrict module,
-										const char name[restrict static 1],
-										const size_t args,
-										const union TaghaVal params[const restrict],
-										union TaghaVal *const restrict retval)
+TAGHA_EXPORT struct TaghaSys tagha_sys_create(void)
 {
-	const restrict TaghaFunc func = _tagha_key_get_item(module->funcs, name);
-	if( func==NULL || func->item==NIL ) {
-		module->err = TaghaErrBadFunc;
-		return false;
+	return (struct TaghaSys){0};
+}
+
+TAGHA_EXPORT bool tagha_sys_clear(struct TaghaSys *const sys)
+{
+	for( size_t i=0; i<sys->len; i++ ) {
+		tagha_module_free(&sys->modules[i]);
+		free(sys->names[i]);
+	}
+	free(sys->modules);
+	free(sys->names);
+	free(sys->slots);
+	*sys = (struct TaghaSys){0};
+	return true;
+}
+
+static NO_NULL size_t _tagha_sys_find(const struct TaghaSys *const restrict sys, const char name[restrict static 1], const uint32_t hash)
+{
+	if( sys->len==0 )
+		return SIZE_MAX;
+	
+	for( size_t i = hash & sys->mask;; i = (i + 1) & sys->mask ) {
+		const struct TaghaSymSlot slot = sys->slots[i];
+		if( slot.index==UINT32_MAX )
+			return SIZE_MAX;
+		else if( slot.hash==hash && !strcmp(sys->names[slot.index], name) )
+			return slot.index;
 	}
-	else return _tagha_module_start(module, func, args, params, retval);
 }
 
-TAGHA_EXPORT bool tagha_module_invoke(struct TaghaModule *const module,
-											const TaghaFunc f,
-											const size_t args,
-											const union TaghaVal params[const restrict],
-											union TaghaVal *const restrict retval)
+static NO_NULL bool _tagha_sys_grow(struct TaghaSys *const sys)
 {
-	if( f->item==NIL ) {
-		module->err = TaghaErrBadFunc;
+	const size_t new_cap = (sys->cap==0) ? 8 : sys->cap << 1;
+	struct TaghaModule **const modules = realloc(sys->modules, sizeof *modules * new_cap);
+	if( modules==NULL )
 		return false;
-	} else {
-		return _tagha_module_start(module, f, args, params, retval);
+	sys->modules = modules;
+	
+	char **const names = realloc(sys->names, sizeof *names * new_cap);
+	if( names==NULL )
+		return false;
+	sys->names = names;
+	
+	const uint32_t slot_count = tagha_sym_slot_count(( uint32_t )new_cap);
+	struct TaghaSymSlot *const slots = malloc(sizeof *slots * slot_count);
+	if( slots==NULL )
+		return false;
+	
+	for( size_t i=0; i<slot_count; i++ )
+		slots[i].index = UINT32_MAX;
+	for( size_t i=0; i<sys->len; i++ )
+		_tagha_sym_slot_insert(slots, slot_count - 1, tagha_sym_hash(names[i]), ( uint32_t )i);
+	
+	free(sys->slots);
+	sys->slots = slots;
+	sys->mask  = slot_count - 1;
+	sys->cap   = new_cap;
+	return true;
+}
+
+TAGHA_EXPORT struct TaghaModule *tagha_sys_load_module(struct TaghaSys *const restrict sys, const char filename[restrict static 1])
+{
+	const uint32_t hash = tagha_sym_hash(filename);
+	const size_t found = _tagha_sys_find(sys, filename, hash);
+	if( found != SIZE_MAX )
+		return sys->modules[found];
+	else if( sys->len==sys->cap && !_tagha_sys_grow(sys) ) {
+		fprintf(stderr, "Tagha Sys Error :: **** Unable to grow module registry for '%s'. ****\n", filename);
+		return NULL;
+	}
+	
+	const size_t name_len = strlen(filename) + 1;
+	char *const restrict name = malloc(name_len);
+	if( name==NULL ) {
+		fprintf(stderr, "Tagha Sys Error :: **** Unable to allocate module name '%s'. ****\n", filename);
+		return NULL;
+	}
+	
+	struct TaghaModule *module = tagha_module_new_from_file_opts(filename, &sys->opts);
+	if( module==NULL ) {
+		free(name);
+		return NULL;
+	}
+	memcpy(name, filename, name_len);
+	tagha_module_link_registry(module);
+	
+	/// resolve the new module's externs from every loaded module & theirs from the new one.
+	for( size_t i=0; i<sys->len; i++ ) {
+		tagha_module_link_module(module, sys->modules[i]);
+		tagha_module_link_module(sys->modules[i], module);
 	}
+	
+	const uint32_t index = ( uint32_t )sys->len++;
+	sys->modules[index] = module;
+	sys->names[index]   = name;
+	_tagha_sym_slot_insert(sys->slots, sys->mask, hash, index);
+	return module;
 }
 
-TAGHA_EXPORT inline int tagha_module_run(struct TaghaModule *const module, const size_t argc, const union TaghaVal argv[const])
+TAGHA_EXPORT struct TaghaModule *tagha_sys_get_module(const struct TaghaSys *const restrict sys, const char filename[restrict static 1])
 {
-	union TaghaVal res = {1};
-	tagha_module_call(module, "main", argc, argv, &res);
-	return res.int32;
+	const size_t found = _tagha_sys_find(sys, filename, tagha_sym_hash(filename));
+	return( found != SIZE_MAX ) ? sys->modules[found] : NULL;
 }
 
-static bool _tagha_module_start(struct TaghaModule *const module, const TaghaFunc func, const size_t args, const union TaghaVal params[const restrict], union TaghaVal *const restrict retval)
+TAGHA_EXPORT TaghaFunc tagha_sys_get_func(const struct TaghaSys *const restrict sys, const char name[restrict static 1])
 {
-	if( func->flags & TAGHA_FLAG_NATIVE ) {
-		if( func->flags & TAGHA_FLAG_LINKED ) {
-			TaghaCFunc *const cfunc = ( TaghaCFunc* )func->item;
-			const union TaghaVal ret = (*cfunc)(module, params);
-			if( retval != NULL )
-				*retval = ret;
-			return module->err==TaghaErrNone;
-		} else {
-			module->err = TaghaErrBadNative;
-			return false;
-		}
+	/// first loaded module that defines `name` wins, same as extern resolution.
+	for( size_t i=0; i<sys->len; i++ ) {
+		const TaghaFunc func = _tagha_key_get_item(sys->modules[i]->funcs, name);
+		if( func != NULL && func->owner==( uintptr_t )sys->modules[i] )
+			return func;
+	}
+	return NULL;
+}
+
+
+
+static NO_NULL void _tagha_sched_push(struct TaghaSchedWorker *const worker, struct TaghaModule *const module)
+{
+	harbol_mutex_lock(&worker->lock);
+	module->queue.next = NULL;
+	module->queue.prev = worker->bottom;
+	if( worker->bottom != NULL )
+		worker->bottom->queue.next = module;
+	else worker->top = module;
+	worker->bottom = module;
+	harbol_mutex_unlock(&worker->lock);
+}
+
+/// the worker takes its most recent module, thieves take the one that waited longest.
+static NO_NULL struct TaghaModule *_tagha_sched_take(struct TaghaSchedWorker *const worker, const bool steal)
+{
+	harbol_mutex_lock(&worker->lock);
+	struct TaghaModule *const module = steal ? worker->top : worker->bottom;
+	if( module != NULL ) {
+		if( module->queue.prev != NULL )
+			module->queue.prev->queue.next = module->queue.next;
+		else worker->top = module->queue.next;
+		if( module->queue.next != NULL )
+			module->queue.next->queue.prev = module->queue.prev;
+		else worker->bottom = module->queue.prev;
+		module->queue.prev = module->queue.next = NULL;
+	}
+	harbol_mutex_unlock(&worker->lock);
+	return module;
+}
+
+/// modules go to the worker that last ran them, ones no worker ran yet are spread by address.
+/// a module can outlive its scheduler, its home is wrapped to this one's workers.
+static NO_NULL void _tagha_sched_ready(struct TaghaSched *const sched, struct TaghaModule *const module)
+{
+	const size_t home = harbol_atomic_load_size(&module->queue.home);
+	const size_t index = (( home != 0 ) ? home - 1 : ( uintptr_t )module >> 4) % sched->len;
+	_tagha_sched_push(&sched->workers[index], module);
+	
+	/// a worker counts itself asleep before checking `ready`, one of the two sees the other.
+	harbol_atomic_fetch_add_size(&sched->ready, 1);
+	if( harbol_atomic_load_size(&sched->sleepers) != 0 ) {
+		harbol_mutex_lock(&sched->lock);
+		harbol_cond_signal(&sched->wake);
+		harbol_mutex_unlock(&sched->lock);
+	}
+}
+
+static NO_NULL void _tagha_task_finish(struct TaghaSched *const sched, struct TaghaModule *const module, struct TaghaTask *const task)
+{
+	if( task->on_done != NULL ) {
+		(*task->on_done)(task->data, module, task->err, task->result);
+		free(task);
+	} else {
+		harbol_mutex_lock(&sched->lock);
+		harbol_atomic_store_size(&task->done, 1);
+		harbol_cond_broadcast(&sched->done);
+		harbol_mutex_unlock(&sched->lock);
+	}
+}
+
+/// runs every call in the module's inbox, the module stays with this worker if more came in meanwhile.
+static NO_NULL void _tagha_sched_run(struct TaghaSchedWorker *const self, struct TaghaModule *const module)
+{
+	harbol_atomic_store_size(&module->queue.home, self->index + 1);
+	
+	/// the inbox is newest first, reversed the calls run in the order they were queued.
+	struct TaghaTask *task = ( struct TaghaTask* )harbol_atomic_exchange_size(&module->queue.inbox, 0);
+	struct TaghaTask *order = NULL;
+	while( task != NULL ) {
+		struct TaghaTask *const next = task->next;
+		task->next = order;
+		order = task;
+		task = next;
+	}
+	
+	size_t ran = 0;
+	while( order != NULL ) {
+		struct TaghaTask *const next = order->next;
+		/// a call the host left suspended keeps the module's stacks, the task fails with its error.
+		if( module->err != TaghaErrSuspended )
+			module->err = TaghaErrNone;
+		tagha_module_invoke(module, order->func, order->args, order->params, &order->result);
+		order->err = module->err;
+		_tagha_task_finish(self->sched, module, order);
+		order = next;
+		ran++;
+	}
+	if( harbol_atomic_fetch_add_size(&module->queue.pending, -ran) != ran )
+		_tagha_sched_ready(self->sched, module);
+}
+
+static void *_tagha_sched_loop(void *const arg)
+{
+	struct TaghaSchedWorker *const self = arg;
+	struct TaghaSched *const sched = self->sched;
+	for( ;; ) {
+		struct TaghaModule *module = _tagha_sched_take(self, false);
+		for( size_t i=1; module==NULL && i<sched->len; i++ )
+			module = _tagha_sched_take(&sched->workers[(self->index + i) % sched->len], true);
+		
+		if( module != NULL ) {
+			harbol_atomic_fetch_add_size(&sched->ready, ( size_t )-1);
+			_tagha_sched_run(self, module);
+			continue;
+		}
+		
+		harbol_mutex_lock(&sched->lock);
+		harbol_atomic_fetch_add_size(&sched->sleepers, 1);
+		const bool idle = harbol_atomic_load_size(&sched->ready)==0;
+		if( idle && harbol_atomic_load_size(&sched->quit)==0 )
+			harbol_cond_wait(&sched->wake, &sched->lock);
+		harbol_atomic_fetch_add_size(&sched->sleepers, ( size_t )-1);
+		const bool stop = idle && harbol_atomic_load_size(&sched->quit) != 0;
+		harbol_mutex_unlock(&sched->lock);
+		if( stop )
+			break;
+	}
+	return NULL;
+}
+
+/// joins the first 'started' workers & frees the rest of the scheduler.
+static NO_NULL void _tagha_sched_stop(struct TaghaSched *const sched, const size_t started)
+{
+	harbol_mutex_lock(&sched->lock);
+	harbol_atomic_store_size(&sched->quit, 1);
+	harbol_cond_broadcast(&sched->wake);
+	harbol_mutex_unlock(&sched->lock);
+	for( size_t i=0; i<started; i++ )
+		harbol_thread_join(&sched->workers[i].thread);
+	
+	/// modules readied after the workers stopped looking run on this thread.
+	for( bool ran = true; ran; ) {
+		ran = false;
+		for( size_t i=0; i<started; i++ ) {
+			struct TaghaModule *module = NULL;
+			while( (module = _tagha_sched_take(&sched->workers[i], false)) != NULL ) {
+				_tagha_sched_run(&sched->workers[i], module);
+				ran = true;
+			}
+		}
+	}
+	
+	for( size_t i=0; i<sched->len; i++ )
+		harbol_mutex_destroy(&sched->workers[i].lock);
+	free(sched->workers);
+	harbol_cond_destroy(&sched->done);
+	harbol_cond_destroy(&sched->wake);
+	harbol_mutex_destroy(&sched->lock);
+	*sched = (struct TaghaSched){ 0 };
+}
+
+TAGHA_EXPORT bool tagha_sched_init(struct TaghaSched *const sched, const size_t threads)
+{
+	*sched = (struct TaghaSched){ 0 };
+	if( threads==0 || !harbol_mutex_init(&sched->lock) )
+		return false;
+	else if( !harbol_cond_init(&sched->wake) ) {
+		harbol_mutex_destroy(&sched->lock);
+		return false;
+	} else if( !harbol_cond_init(&sched->done) ) {
+		harbol_cond_destroy(&sched->wake);
+		harbol_mutex_destroy(&sched->lock);
+		return false;
+	}
+	
+	sched->workers = calloc(threads, sizeof *sched->workers);
+	if( sched->workers==NULL ) {
+		_tagha_sched_stop(sched, 0);
+		return false;
+	}
+	for( ; sched->len<threads; sched->len++ ) {
+		if( !harbol_mutex_init(&sched->workers[sched->len].lock) ) {
+			_tagha_sched_stop(sched, 0);
+			return false;
+		}
+		sched->workers[sched->len].sched = sched;
+		sched->workers[sched->len].index = sched->len;
+	}
+	/// every deque exists before the first worker goes looking for modules to steal.
+	for( size_t i=0; i<threads; i++ ) {
+		if( !harbol_thread_create(&sched->workers[i].thread, &_tagha_sched_loop, &sched->workers[i]) ) {
+			_tagha_sched_stop(sched, i);
+			return false;
+		}
+	}
+	return true;
+}
+
+TAGHA_EXPORT void tagha_sched_clear(struct TaghaSched *const sched)
+{
+	_tagha_sched_stop(sched, sched->len);
+}
+
+static NO_NULL void _tagha_sched_queue(struct TaghaSched *const sched, struct TaghaModule *const module, struct TaghaTask *const task)
+{
+	/// counted before it's in the inbox, a worker never takes more calls than were counted.
+	const bool idle = harbol_atomic_fetch_add_size(&module->queue.pending, 1)==0;
+	size_t head = 0;
+	do {
+		head = harbol_atomic_load_size(&module->queue.inbox);
+		task->next = ( struct TaghaTask* )head;
+	} while( !harbol_atomic_cas_size(&module->queue.inbox, head, ( size_t )task) );
+	
+	/// only whoever finds the module idle hands it to a worker.
+	if( idle )
+		_tagha_sched_ready(sched, module);
+}
+
+static struct TaghaTask *_tagha_task_new(struct TaghaSched *const sched, const TaghaFunc func, const size_t args, const union TaghaVal params[const], TaghaTaskCallback *const on_done, void *const data)
+{
+	if( func->item==NIL )
+		return NULL;
+	
+	struct TaghaTask *const task = calloc(1, sizeof *task + sizeof *params * args);
+	if( task==NULL )
+		return NULL;
+	
+	task->sched   = sched;
+	task->func    = func;
+	task->on_done = on_done;
+	task->data    = data;
+	task->args    = args;
+	if( args > 0 )
+		memcpy(task->params, params, sizeof *params * args);
+	return task;
+}
+
+TAGHA_EXPORT struct TaghaTask *tagha_sched_submit(struct TaghaSched *const sched, struct TaghaModule *const module, const TaghaFunc func, const size_t args, const union TaghaVal params[const])
+{
+	struct TaghaTask *const task = _tagha_task_new(sched, func, args, params, NULL, NULL);
+	if( task != NULL )
+		_tagha_sched_queue(sched, module, task);
+	return task;
+}
+
+TAGHA_EXPORT bool tagha_sched_post(struct TaghaSched *const sched, struct TaghaModule *const module, const TaghaFunc func, const size_t args, const union TaghaVal params[const], TaghaTaskCallback *const on_done, void *const data)
+{
+	/// the task can be done & freed before this returns.
+	struct TaghaTask *const task = _tagha_task_new(sched, func, args, params, on_done, data);
+	if( task==NULL )
+		return false;
+	else {
+		_tagha_sched_queue(sched, module, task);
+		return true;
+	}
+}
+
+TAGHA_EXPORT bool tagha_task_done(const struct TaghaTask *const task)
+{
+	return harbol_atomic_load_size(( volatile size_t* )&task->done) != 0;
+}
+
+TAGHA_EXPORT int tagha_task_wait(struct TaghaTask *const task, union TaghaVal *const retval)
+{
+	struct TaghaSched *const sched = task->sched;
+	harbol_mutex_lock(&sched->lock);
+	while( harbol_atomic_load_size(&task->done)==0 )
+		harbol_cond_wait(&sched->done, &sched->lock);
+	harbol_mutex_unlock(&sched->lock);
+	
+	const int err = task->err;
+	if( retval != NULL )
+		*retval = task->result;
+	free(task);
+	return err;
+}
+
+TAGHA_EXPORT bool tagha_module_call(struct TaghaModule *const restrict module,
+										const char name[restrict static 1],
+										const size_t args,
+										const union TaghaVal params[const restrict],
+										union TaghaVal *const restrict retval)
+{
+	const restrict TaghaFunc func = _tagha_key_get_item(module->funcs, name);
+	if( func==NULL || func->item==NIL ) {
+		module->err = TaghaErrBadFunc;
+		return false;
+	}
+	else return _tagha_module_start(module, func, args, params, retval);
+}
+
+TAGHA_EXPORT bool tagha_module_invoke(struct TaghaModule *const module,
+											const TaghaFunc f,
+											const size_t args,
+											const union TaghaVal params[const restrict],
+											union TaghaVal *const restrict retval)
+{
+	if( f->item==NIL ) {
+		module->err = TaghaErrBadFunc;
+		return false;
+	} else {
+		return _tagha_module_start(module, f, args, params, retval);
+	}
+}
+
+TAGHA_EXPORT inline int tagha_module_run(struct TaghaModule *const module, const size_t argc, const union TaghaVal argv[const])
+{
+	union TaghaVal res = {1};
+	tagha_module_call(module, "main", argc, argv, &res);
+	return res.int32;
+}
+
+static void *_tagha_worker_run(void *const arg)
+{
+	struct TaghaWorker *const worker = arg;
+	tagha_module_invoke(&worker->ctxt, worker->func, worker->args, worker->params, &worker->result);
+	return NULL;
+}
+
+static NO_NULL void _tagha_context_clear(struct TaghaModule *const ctxt)
+{
+	struct TaghaModule *const module = ctxt->parent;
+	tagha_module_heap_free(module, ctxt->opstack);
+	tagha_module_heap_free(module, ctxt->callstack);
+	harbol_atomic_fetch_add_size(&module->workers, ( size_t )-1);
+	*ctxt = (struct TaghaModule){ 0 };
+}
+
+/// the context is a copy of the caller with its own stacks, carved from the module's heap.
+/// copying the caller keeps the symbol tables 'func' was looked up from, even mid extern call.
+static NO_NULL bool _tagha_context_init(struct TaghaModule *const restrict ctxt, const struct TaghaModule *const restrict caller)
+{
+	struct TaghaModule *const module = ( caller->parent != NULL ) ? caller->parent : ( struct TaghaModule* )caller;
+	/// only the mempool has a thread-safe mode, arena scopes are tied to the calling thread.
+	if( module->flags & (TAGHA_MODULE_HEAP_TLSF | TAGHA_MODULE_HEAP_SLAB | TAGHA_MODULE_HEAP_ARENA) )
+		return false;
+	else if( !harbol_mempool_share(&module->heap) )
+		return false;
+	
+	*ctxt            = *caller;
+	ctxt->parent     = module;
+	ctxt->workers    = 0;
+	ctxt->call_depth = 0;
+	ctxt->err        = TaghaErrNone;
+	ctxt->cond       = 0;
+	ctxt->lr         = NIL;
+	ctxt->opstack    = tagha_module_heap_alloc_persistent(module, module->opstack_size);
+	ctxt->callstack  = tagha_module_heap_alloc_persistent(module, module->callstack_size);
+	harbol_atomic_fetch_add_size(&module->workers, 1);
+	if( ctxt->opstack==NIL || ctxt->callstack==NIL ) {
+		_tagha_context_clear(ctxt);
+		return false;
+	}
+	ctxt->osp = ctxt->opstack + ctxt->opstack_size;
+	ctxt->csp = ctxt->callstack;
+	return true;
+}
+
+static NO_NULL void _tagha_worker_free(struct TaghaWorker *const worker)
+{
+	_tagha_context_clear(&worker->ctxt);
+	free(worker);
+}
+
+TAGHA_EXPORT struct TaghaWorker *tagha_module_spawn(struct TaghaModule *const ctxt, const TaghaFunc func, const size_t args, const union TaghaVal params[const])
+{
+	if( func->item==NIL )
+		return NULL;
+	
+	struct TaghaWorker *const worker = calloc(1, sizeof *worker + sizeof *params * args);
+	if( worker==NULL )
+		return NULL;
+	else if( !_tagha_context_init(&worker->ctxt, ctxt) ) {
+		free(worker);
+		return NULL;
+	}
+	worker->func = func;
+	worker->args = args;
+	if( args > 0 )
+		memcpy(worker->params, params, sizeof *params * args);
+	
+	if( !harbol_thread_create(&worker->thread, &_tagha_worker_run, worker) ) {
+		_tagha_worker_free(worker);
+		return NULL;
+	}
+	return worker;
+}
+
+TAGHA_EXPORT int tagha_worker_join(struct TaghaWorker *const worker, union TaghaVal *const retval)
+{
+	harbol_thread_join(&worker->thread);
+	const int err = worker->ctxt.err;
+	if( retval != NULL )
+		*retval = worker->result;
+	_tagha_worker_free(worker);
+	return err;
+}
+
+TAGHA_EXPORT void tagha_module_set_pool(struct TaghaModule *const module, struct HarbolThreadPool *const pool)
+{
+	module->pool = pool;
+}
+
+struct TaghaParFor {
+	struct TaghaModule *ctxts;  /// one per pool thread, those without a parent couldn't be made.
+	TaghaFunc           func;
+	volatile size_t     next, err;
+	size_t              end, grain;
+};
+
+/// chunks are handed out until the range runs out or a chunk fails.
+static NO_NULL void _tagha_par_for_run(struct TaghaParFor *const job, struct TaghaModule *const ctxt)
+{
+	while( harbol_atomic_load_size(&job->err)==( size_t )TaghaErrNone ) {
+		const size_t lo = harbol_atomic_fetch_add_size(&job->next, job->grain);
+		if( lo >= job->end )
+			return;
+		
+		const size_t hi = ( job->end - lo > job->grain ) ? lo + job->grain : job->end;
+		const union TaghaVal params[] = { { .size = lo }, { .size = hi } };
+		if( !tagha_module_invoke(ctxt, job->func, 2, params, NULL) )
+			harbol_atomic_cas_size(&job->err, ( size_t )TaghaErrNone, ( size_t )ctxt->err);
+	}
+}
+
+static void _tagha_par_for_thread(void *const arg, const size_t index)
+{
+	struct TaghaParFor *const job = arg;
+	if( job->ctxts[index].parent != NULL )
+		_tagha_par_for_run(job, &job->ctxts[index]);
+}
+
+/// every chunk runs in a context of its thread, the caller works through chunks in its own.
+TAGHA_EXPORT bool tagha_module_parallel_for(struct TaghaModule *const ctxt, const TaghaFunc func, const size_t begin, const size_t end, const size_t grain)
+{
+	if( func->item==NIL ) {
+		ctxt->err = TaghaErrBadFunc;
+		return false;
+	} else if( begin >= end )
+		return true;
+	
+	struct TaghaParFor job = { .func = func, .next = begin, .err = ( size_t )TaghaErrNone, .end = end, .grain = ( grain > 0 ) ? grain : 1 };
+	struct HarbolThreadPool *const pool = _tagha_module_root(ctxt)->pool;
+	/// no more threads than there are chunks the caller won't get to.
+	const size_t chunks = (end - begin - 1) / job.grain + 1;
+	size_t threads = ( pool != NULL && !harbol_thread_pool_owns_thread(pool) ) ? pool->len : 0;
+	if( threads > chunks - 1 )
+		threads = chunks - 1;
+	
+	/// every pool thread gets the job, those past 'threads' find no context & return.
+	job.ctxts = ( threads > 0 ) ? calloc(pool->len, sizeof *job.ctxts) : NULL;
+	bool started = false;
+	if( job.ctxts != NULL ) {
+		for( size_t i=0; i<threads; i++ )
+			_tagha_context_init(&job.ctxts[i], ctxt);
+		started = harbol_thread_pool_start(pool, &_tagha_par_for_thread, &job);
+	}
+	_tagha_par_for_run(&job, ctxt);
+	
+	if( started )
+		harbol_thread_pool_wait(pool);
+	if( job.ctxts != NULL ) {
+		for( size_t i=0; i<threads; i++ )
+			if( job.ctxts[i].parent != NULL )
+				_tagha_context_clear(&job.ctxts[i]);
+		free(job.ctxts);
+	}
+	
+	const int err = ( int )job.err;
+	if( err != TaghaErrNone ) {
+		ctxt->err = err;
+		return false;
+	}
+	return true;
+}
+
+/// uintptr_t thread_spawn(void (*fn)(void*), void *arg); 0 if the thread couldn't start.
+static union TaghaVal _tagha_native_thread_spawn(struct TaghaModule *const ctxt, const union TaghaVal params[const static 2])
+{
+	const TaghaFunc func = ( TaghaFunc )params[0].uintptr;
+	const struct TaghaWorker *const worker = ( func != NULL ) ? tagha_module_spawn(ctxt, func, 1, &params[1]) : NULL;
+	return ( union TaghaVal ){ .uintptr = ( uintptr_t )worker };
+}
+
+/// uint64_t thread_join(uintptr_t thread); an error in the thread is thrown in the joiner.
+static union TaghaVal _tagha_native_thread_join(struct TaghaModule *const ctxt, const union TaghaVal params[const static 1])
+{
+	struct TaghaWorker *const worker = ( struct TaghaWorker* )params[0].uintptr;
+	union TaghaVal result = { 0 };
+	if( worker==NULL ) {
+		tagha_module_throw_err(ctxt, TaghaErrBadPtr);
+		return result;
+	}
+	const int err = tagha_worker_join(worker, &result);
+	if( err != TaghaErrNone )
+		tagha_module_throw_err(ctxt, err);
+	return result;
+}
+
+/// void parallel_for(void (*fn)(size_t lo, size_t hi), size_t begin, size_t end, size_t grain);
+static union TaghaVal _tagha_native_parallel_for(struct TaghaModule *const ctxt, const union TaghaVal params[const static 4])
+{
+	const TaghaFunc func = ( TaghaFunc )params[0].uintptr;
+	if( func==NULL )
+		tagha_module_throw_err(ctxt, TaghaErrBadFunc);
+	else tagha_module_parallel_for(ctxt, func, params[1].size, params[2].size, params[3].size);
+	return ( union TaghaVal ){ 0 };
+}
+
+TAGHA_EXPORT const struct TaghaNative tagha_thread_natives[] = {
+	{ "thread_spawn", &_tagha_native_thread_spawn },
+	{ "thread_join",  &_tagha_native_thread_join },
+	{ "parallel_for", &_tagha_native_parallel_for },
+	{ NULL, NULL }
+};
+
+static NEVER_NULL(1,2) bool _tagha_module_enter(struct TaghaModule *module, TaghaFunc func, size_t args, const union TaghaVal params[], union TaghaVal *retval);
+
+/// closes the arena scope `_tagha_module_start` opened.
+static NO_NULL void _tagha_module_finish(struct TaghaModule *const ctxt, const uintptr_t mark)
+{
+	struct TaghaModule *const module = _tagha_module_root(ctxt);
+	ctxt->call_depth--;
+	if( module->flags & TAGHA_MODULE_HEAP_ARENA )
+		harbol_cache_arena_rewind(&module->heap.stack, mark);
+	
+	/// a grown heap that went a while without needing more is shrunk back.
+	if( ctxt==module && module->heap_range.reserved != 0 && module->call_depth==0
+			&& harbol_atomic_load_size(&module->workers)==0
+			&& module->heap.stack.size > module->heap_range.min_size
+			&& ++module->heap_range.idle_calls >= TAGHA_HEAP_IDLE_CALLS )
+		tagha_module_heap_trim(module);
+}
+
+/// host calls open an arena scope, whatever the call allocated from the arena goes away when it returns.
+static bool _tagha_module_start(struct TaghaModule *const ctxt, const TaghaFunc func, const size_t args, const union TaghaVal params[const restrict], union TaghaVal *const restrict retval)
+{
+	/// the suspended call owns the stacks until it's resumed to its end.
+	if( ctxt->err==TaghaErrSuspended )
+		return false;
+	
+	const uintptr_t mark = _tagha_module_root(ctxt)->heap.stack.arena;
+	ctxt->call_depth++;
+	const bool result = _tagha_module_enter(ctxt, func, args, params, retval);
+	if( ctxt->err==TaghaErrSuspended ) {
+		ctxt->suspended.arena = mark;
+		return false;
+	}
+	_tagha_module_finish(ctxt, mark);
+	return result;
+}
+
+/// pops the host call's frame & gives back what an extern call, error or `halt` could've left changed.
+static NEVER_NULL(1,2) bool _tagha_module_leave(struct TaghaModule *const restrict module, const struct TaghaSuspension *const restrict saved, union TaghaVal *const restrict retval)
+{
+	module->funcs = saved->funcs;
+	module->vars  = saved->vars;
+	module->csp   = saved->csp;
+	module->lr    = saved->lr;
+	if( retval != NULL )
+		*retval = *( const union TaghaVal* )module->osp;
+	module->osp += saved->bytes;
+	return module->err==TaghaErrNone;
+}
+
+static bool _tagha_module_enter(struct TaghaModule *const module, const TaghaFunc func, const size_t args, const union TaghaVal params[const restrict], union TaghaVal *const restrict retval)
+{
+	if( func->flags & TAGHA_FLAG_NATIVE ) {
+		if( func->flags & TAGHA_FLAG_LINKED || _tagha_native_lazy_link((( const struct TaghaModule* )func->owner)->own_funcs, func) ) {
+			TaghaCFunc *const cfunc = ( TaghaCFunc* )func->item;
+			/// no script to pause when the host calls a native directly.
+			module->call_depth++;
+			const union TaghaVal ret = (*cfunc)(module, params);
+			module->call_depth--;
+			if( retval != NULL )
+				*retval = ret;
+			return module->err==TaghaErrNone;
+		} else {
+			module->err = TaghaErrBadNative;
+			return false;
+		}
 	} else {
 		const size_t bytes = sizeof(union TaghaVal) * (args + 1); /// one more for ret value.
 		if( module->osp - bytes < module->opstack ) {
@@ -391,17 +1545,61 @@ static bool _tagha_module_start(struct TaghaModule *const module, const TaghaFun
 			module->osp -= bytes;
 			union TaghaVal *const restrict rsp = ( union TaghaVal* )module->osp;
 			memcpy(rsp + 1, params, bytes - sizeof(union TaghaVal));
+			struct TaghaSuspension saved = { module->funcs, module->vars, module->csp, module->lr, NIL, bytes, NULL };
 			module->ip = func->item;
 			module->lr = NIL;
 			_tagha_module_exec(module);
-			if( retval != NULL )
-				*retval = *( const union TaghaVal* )module->osp;
-			module->osp += bytes;
-			return module->err==TaghaErrNone;
+			if( module->err==TaghaErrSuspended ) {
+				/// the frame stays pushed until the call is resumed to its end.
+				saved.slot = module->suspended.slot;
+				module->suspended = saved;
+				return false;
+			}
+			return _tagha_module_leave(module, &saved, retval);
 		}
 	}
 }
 
+TAGHA_EXPORT bool tagha_module_suspend(struct TaghaModule *const module)
+{
+	if( module->err != TaghaErrNone || !_tagha_module_can_suspend(module) )
+		return false;
+	/// natives run on top of the script's frame, its 'r0' is the native's return slot.
+	module->suspended.slot = ( union TaghaVal* )module->osp;
+	module->err = TaghaErrSuspended;
+	return true;
+}
+
+TAGHA_EXPORT bool tagha_module_resume(struct TaghaModule *const module, union TaghaVal *const restrict retval)
+{
+	if( module->err != TaghaErrSuspended )
+		return false;
+	
+	module->err = TaghaErrNone;
+	_tagha_module_exec(module);
+	if( module->err==TaghaErrSuspended )
+		return false;
+	
+	const struct TaghaSuspension saved = module->suspended;
+	const bool result = _tagha_module_leave(module, &saved, retval);
+	_tagha_module_finish(module, saved.arena);
+	return result;
+}
+
+TAGHA_EXPORT bool tagha_module_resume_with(struct TaghaModule *const module, const union TaghaVal result, union TaghaVal *const restrict retval)
+{
+	if( module->err != TaghaErrSuspended || module->suspended.slot==NULL )
+		return false;
+	
+	*module->suspended.slot = result;
+	return tagha_module_resume(module, retval);
+}
+
+TAGHA_EXPORT bool tagha_module_suspended(const struct TaghaModule *const module)
+{
+	return module->err==TaghaErrSuspended;
+}
+
 
 static void _tagha_push_lr(struct TaghaModule *const vm)
 {
@@ -417,22 +1615,78 @@ static void _tagha_pop_lr(struct TaghaModule *const vm)
 	vm->lr = *call_stack;
 }
 
+/// extern calls keep running in the same dispatch loop,
+/// the caller's state is saved on the call stack & `lr` is set to `TAGHA_EXTERN_LR` so `ret` restores it.
+enum { TAGHA_EXTERN_LR = 1 }; /// never a valid return address.
+struct TaghaExternFrame {
+	uintptr_t
+		funcs,  /// caller's func table.
+		vars,   /// caller's var table.
+		ret_pc, /// instruction after the call.
+		lr      /// caller's link register.
+	;
+};
 
-static void _tagha_module_exec(struct TaghaModule *const vm)
+static NO_NULL NO_INLINE bool _tagha_push_extern_frame(struct TaghaModule *const restrict vm, const struct TaghaModule *const restrict lib, const uintptr_t ret_pc)
 {
-	/// pc is restricted and must not access beyond the function table!
-	union TaghaPtr pc = { ( const uint64_t* )vm->ip };
-	const uintptr_t mem_bnds_diff = vm->high_seg - vm->low_seg;
-	
-#define X(x) #x ,
-	/// for debugging purposes.
-	//const char *const restrict op_to_cstr[] = { TAGHA_INSTR_SET };
-#undef X
-	
-#define X(x) &&exec_##x ,
-	/// our instruction dispatch table.
-	static const void *const restrict dispatch[] = { TAGHA_INSTR_SET };
-#undef X
+	if( vm->csp + sizeof(struct TaghaExternFrame) > vm->callstack + vm->callstack_size ) {
+		vm->err = TaghaErrCallStackOF;
+		return false;
+	} else {
+		struct TaghaExternFrame *const frame = ( struct TaghaExternFrame* )vm->csp;
+		*frame = (struct TaghaExternFrame){
+			.funcs  = ( uintptr_t )vm->funcs,
+			.vars   = ( uintptr_t )vm->vars,
+			.ret_pc = ret_pc,
+			.lr     = vm->lr
+		};
+		vm->csp  += sizeof *frame;
+		vm->funcs = lib->own_funcs;
+		vm->vars  = lib->own_vars;
+		vm->lr    = TAGHA_EXTERN_LR;
+		return true;
+	}
+}
+
+static NO_NULL NO_INLINE uintptr_t _tagha_pop_extern_frame(struct TaghaModule *const vm)
+{
+	vm->csp -= sizeof(struct TaghaExternFrame);
+	const struct TaghaExternFrame *const frame = ( const struct TaghaExternFrame* )vm->csp;
+	vm->funcs = ( const struct TaghaSymTable* )frame->funcs;
+	vm->vars  = ( const struct TaghaSymTable* )frame->vars;
+	vm->lr    = frame->lr;
+	return frame->ret_pc;
+}
+
+
+/// thread contexts pick up heap growth from their module after natives.
+/// the module's bound is only written under the heap lock & only ever grows while contexts run,
+/// it's read atomically since other contexts can grow the heap at the same time.
+static inline NO_NULL uintptr_t _tagha_module_mem_bounds(struct TaghaModule *const vm)
+{
+	if( vm->parent==NULL )
+		return harbol_atomic_load_uintptr(&vm->high_seg) - vm->low_seg;
+	
+	vm->high_seg = harbol_atomic_load_uintptr(&vm->parent->high_seg);
+	return vm->high_seg - vm->low_seg;
+}
+
+static void _tagha_module_exec(struct TaghaModule *const vm)
+{
+	/// pc is restricted and must not access beyond the function table!
+	union TaghaPtr pc = { ( const uint64_t* )vm->ip };
+	/// natives can grow the heap, the bounds are reloaded after them.
+	uintptr_t mem_bnds_diff = _tagha_module_mem_bounds(vm);
+	
+#define X(x) #x ,
+	/// for debugging purposes.
+	//const char *const restrict op_to_cstr[] = { TAGHA_INSTR_SET };
+#undef X
+	
+#define X(x) &&exec_##x ,
+	/// our instruction dispatch table.
+	static const void *const restrict dispatch[] = { TAGHA_INSTR_SET };
+#undef X
 #undef TAGHA_INSTR_SET
 	
 #	define DBG_JMP \
@@ -1017,39 +2271,32 @@ static void _tagha_module_exec(struct TaghaModule *const vm)
 	exec_call: { /// u8: opcode | u16: index
 		const uint32_t index = *pc.uint16++;
 		const TaghaFunc func = vm->funcs->table + (index - 1);
+		if( (func->item==NIL || func->owner==NIL) && !_tagha_native_lazy_link(vm->funcs, func) ) {
+			vm->err = func->flags;
+			return;
+		}
 		const uintptr_t item = func->item;
 		const uint32_t flags = func->flags;
-		if( item==NIL || func->owner==NIL ) {
-			vm->err = flags;
-			return;
-		} else if( flags & TAGHA_FLAG_NATIVE ) {
+		if( flags & TAGHA_FLAG_NATIVE ) {
 			TaghaCFunc *const cfunc = ( TaghaCFunc* )item;
 			union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
 			*rsp = (*cfunc)(vm, rsp + 1);
 			if( vm->err != TaghaErrNone ) {
+				/// a suspended script picks up after the call.
+				vm->ip = ( uintptr_t )pc.uint8;
 				return;
 			} else {
+				mem_bnds_diff = _tagha_module_mem_bounds(vm);
 				DISPATCH();
 			}
 		} else if( flags & TAGHA_FLAG_EXTERN ) {
 			const struct TaghaModule *const restrict lib = ( const struct TaghaModule* )func->owner;
-			/// save old symbol tables.
-			const uintptr_t
-				saved_funcs = ( uintptr_t )vm->funcs,
-				saved_vars  = ( uintptr_t )vm->vars
-			;
-			vm->funcs = lib->funcs;
-			vm->vars  = lib->vars;
-			
-			_tagha_push_lr(vm);
-			vm->ip = item;
-			vm->lr = NIL;
-			_tagha_module_exec(vm);
-			
-			_tagha_pop_lr(vm);
-			vm->funcs = ( const struct TaghaSymTable* )saved_funcs;
-			vm->vars  = ( const struct TaghaSymTable* )saved_vars;
-			DISPATCH();
+			if( !_tagha_push_extern_frame(vm, lib, ( uintptr_t )pc.uint8) ) {
+				return;
+			} else {
+				pc.uint8 = ( const uint8_t* )item;
+				DISPATCH();
+			}
 		} else {
 			vm->lr = ( uintptr_t )pc.uint8;
 			pc.uint8 = ( const uint8_t* )item;
@@ -1066,41 +2313,31 @@ static void _tagha_module_exec(struct TaghaModule *const vm)
 		} else {
 			const uintptr_t item = func->item;
 			if( func->flags & TAGHA_FLAG_NATIVE ) {
-				if( item==NIL ) {
+				if( item==NIL && !_tagha_native_lazy_link((( const struct TaghaModule* )func->owner)->own_funcs, func) ) {
 					vm->err = TaghaErrBadNative;
 					return;
 				} else {
-					TaghaCFunc *const cfunc = ( TaghaCFunc* )item;
+					TaghaCFunc *const cfunc = ( TaghaCFunc* )func->item;
 					*rsp = (*cfunc)(vm, rsp + 1);
 					if( vm->err != TaghaErrNone ) {
+						vm->ip = ( uintptr_t )pc.uint8;
 						return;
 					} else {
+						mem_bnds_diff = _tagha_module_mem_bounds(vm);
 						DISPATCH();
 					}
 				}
-			} else if( func->owner != ( uintptr_t )vm ) {
-				/// if not same owner, it's an external function.
-				if( func->owner==NIL ) {
-					vm->err = TaghaErrBadExtern;
+			} else if( func->owner==NIL ) {
+				vm->err = TaghaErrBadExtern;
+				return;
+			} else if( (( const struct TaghaModule* )func->owner)->own_funcs != vm->funcs ) {
+				/// the tables in use tell which module's code is running, a function of any other module is external.
+				/// that covers a library calling back into the module that called it.
+				const struct TaghaModule *const restrict lib = ( const struct TaghaModule* )func->owner;
+				if( !_tagha_push_extern_frame(vm, lib, ( uintptr_t )pc.uint8) ) {
 					return;
 				} else {
-					const struct TaghaModule *const restrict lib = ( const struct TaghaModule* )func->owner;
-					/// save old symbol tables.
-					const uintptr_t
-						saved_funcs = ( uintptr_t )vm->funcs,
-						saved_vars  = ( uintptr_t )vm->vars
-					;
-					vm->funcs = lib->funcs;
-					vm->vars  = lib->vars;
-					
-					_tagha_push_lr(vm);
-					vm->ip = item;
-					vm->lr = NIL;
-					_tagha_module_exec(vm);
-					
-					_tagha_pop_lr(vm);
-					vm->funcs = ( const struct TaghaSymTable* )saved_funcs;
-					vm->vars  = ( const struct TaghaSymTable* )saved_vars;
+					pc.uint8 = ( const uint8_t* )item;
 					DISPATCH();
 				}
 			} else {
@@ -1112,13 +2349,16 @@ static void _tagha_module_exec(struct TaghaModule *const vm)
 	}
 	
 	exec_ret: { /// u8: opcode
-		pc.uint8 = ( const uint8_t* )vm->lr;
-		if( pc.uint8==NULL ) {
-	exec_halt:
-			return;
-		} else {
+		const uintptr_t lr = vm->lr;
+		if( lr > TAGHA_EXTERN_LR ) {
+			pc.uint8 = ( const uint8_t* )lr;
+			DISPATCH();
+		} else if( lr==TAGHA_EXTERN_LR ) {
+			pc.uint8 = ( const uint8_t* )_tagha_pop_extern_frame(vm);
 			DISPATCH();
 		}
+	exec_halt:
+		return;
 	}
 	
 	/// treated as nop if float32_t is defined but not the other.
@@ -1808,4 +3048,489 @@ static void _tagha_module_exec(struct TaghaModule *const vm)
 #endif
 		DISPATCH();
 	}
+	
+	/// atomics have to be naturally aligned, misaligned addresses are bad pointers.
+	exec_ald1: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem - vm->low_seg) > mem_bnds_diff ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint8_t *const ptr = ( uint8_t* )mem;
+			rsp[dst].uint64 = __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_ald2: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+1 - vm->low_seg) > mem_bnds_diff || (mem & 1) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint16_t *const ptr = ( uint16_t* )mem;
+			rsp[dst].uint64 = __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_ald4: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+3 - vm->low_seg) > mem_bnds_diff || (mem & 3) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint32_t *const ptr = ( uint32_t* )mem;
+			rsp[dst].uint64 = __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_ald8: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+7 - vm->low_seg) > mem_bnds_diff || (mem & 7) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint64_t *const ptr = ( uint64_t* )mem;
+			rsp[dst].uint64 = __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	
+	exec_ast1: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		const union TaghaVal *const restrict rsp = ( const union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[dst].uintptr + offset;
+		if( (mem - vm->low_seg) > mem_bnds_diff ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint8_t *const ptr = ( uint8_t* )mem;
+			__atomic_store_n(ptr, ( uint8_t )rsp[src].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_ast2: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		const union TaghaVal *const restrict rsp = ( const union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[dst].uintptr + offset;
+		if( (mem+1 - vm->low_seg) > mem_bnds_diff || (mem & 1) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint16_t *const ptr = ( uint16_t* )mem;
+			__atomic_store_n(ptr, ( uint16_t )rsp[src].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_ast4: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		const union TaghaVal *const restrict rsp = ( const union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[dst].uintptr + offset;
+		if( (mem+3 - vm->low_seg) > mem_bnds_diff || (mem & 3) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint32_t *const ptr = ( uint32_t* )mem;
+			__atomic_store_n(ptr, ( uint32_t )rsp[src].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_ast8: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		const union TaghaVal *const restrict rsp = ( const union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[dst].uintptr + offset;
+		if( (mem+7 - vm->low_seg) > mem_bnds_diff || (mem & 7) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint64_t *const ptr = ( uint64_t* )mem;
+			__atomic_store_n(ptr, ( uint64_t )rsp[src].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	
+	exec_acas1: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem - vm->low_seg) > mem_bnds_diff ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint8_t *const ptr = ( uint8_t* )mem;
+			/// stores 'dst + 1' if memory holds 'dst', 'dst' gets the old value.
+			uint8_t expected = ( uint8_t )rsp[dst].uint64;
+			vm->cond = __atomic_compare_exchange_n(ptr, &expected, ( uint8_t )rsp[dst + 1].uint64, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+			rsp[dst].uint64 = expected;
+			DISPATCH();
+		}
+	}
+	exec_acas2: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+1 - vm->low_seg) > mem_bnds_diff || (mem & 1) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint16_t *const ptr = ( uint16_t* )mem;
+			/// stores 'dst + 1' if memory holds 'dst', 'dst' gets the old value.
+			uint16_t expected = ( uint16_t )rsp[dst].uint64;
+			vm->cond = __atomic_compare_exchange_n(ptr, &expected, ( uint16_t )rsp[dst + 1].uint64, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+			rsp[dst].uint64 = expected;
+			DISPATCH();
+		}
+	}
+	exec_acas4: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+3 - vm->low_seg) > mem_bnds_diff || (mem & 3) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint32_t *const ptr = ( uint32_t* )mem;
+			/// stores 'dst + 1' if memory holds 'dst', 'dst' gets the old value.
+			uint32_t expected = ( uint32_t )rsp[dst].uint64;
+			vm->cond = __atomic_compare_exchange_n(ptr, &expected, ( uint32_t )rsp[dst + 1].uint64, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+			rsp[dst].uint64 = expected;
+			DISPATCH();
+		}
+	}
+	exec_acas8: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+7 - vm->low_seg) > mem_bnds_diff || (mem & 7) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint64_t *const ptr = ( uint64_t* )mem;
+			/// stores 'dst + 1' if memory holds 'dst', 'dst' gets the old value.
+			uint64_t expected = ( uint64_t )rsp[dst].uint64;
+			vm->cond = __atomic_compare_exchange_n(ptr, &expected, ( uint64_t )rsp[dst + 1].uint64, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+			rsp[dst].uint64 = expected;
+			DISPATCH();
+		}
+	}
+	
+	exec_aadd1: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem - vm->low_seg) > mem_bnds_diff ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint8_t *const ptr = ( uint8_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_add(ptr, ( uint8_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aadd2: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+1 - vm->low_seg) > mem_bnds_diff || (mem & 1) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint16_t *const ptr = ( uint16_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_add(ptr, ( uint16_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aadd4: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+3 - vm->low_seg) > mem_bnds_diff || (mem & 3) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint32_t *const ptr = ( uint32_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_add(ptr, ( uint32_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aadd8: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+7 - vm->low_seg) > mem_bnds_diff || (mem & 7) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint64_t *const ptr = ( uint64_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_add(ptr, ( uint64_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	
+	exec_aand1: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem - vm->low_seg) > mem_bnds_diff ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint8_t *const ptr = ( uint8_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_and(ptr, ( uint8_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aand2: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+1 - vm->low_seg) > mem_bnds_diff || (mem & 1) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint16_t *const ptr = ( uint16_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_and(ptr, ( uint16_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aand4: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+3 - vm->low_seg) > mem_bnds_diff || (mem & 3) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint32_t *const ptr = ( uint32_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_and(ptr, ( uint32_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aand8: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+7 - vm->low_seg) > mem_bnds_diff || (mem & 7) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint64_t *const ptr = ( uint64_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_and(ptr, ( uint64_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	
+	exec_aor1: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem - vm->low_seg) > mem_bnds_diff ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint8_t *const ptr = ( uint8_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_or(ptr, ( uint8_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aor2: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+1 - vm->low_seg) > mem_bnds_diff || (mem & 1) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint16_t *const ptr = ( uint16_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_or(ptr, ( uint16_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aor4: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+3 - vm->low_seg) > mem_bnds_diff || (mem & 3) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint32_t *const ptr = ( uint32_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_or(ptr, ( uint32_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_aor8: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+7 - vm->low_seg) > mem_bnds_diff || (mem & 7) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint64_t *const ptr = ( uint64_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_or(ptr, ( uint64_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	
+	exec_axor1: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem - vm->low_seg) > mem_bnds_diff ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint8_t *const ptr = ( uint8_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_xor(ptr, ( uint8_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_axor2: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+1 - vm->low_seg) > mem_bnds_diff || (mem & 1) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint16_t *const ptr = ( uint16_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_xor(ptr, ( uint16_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_axor4: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+3 - vm->low_seg) > mem_bnds_diff || (mem & 3) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint32_t *const ptr = ( uint32_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_xor(ptr, ( uint32_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	exec_axor8: { /// u8: opcode | u8: dest reg | u8: src reg | i16: offset
+		const uint32_t instr = *pc.uint32++;
+		const uint32_t dst   = instr & 0xff;
+		const uint32_t src   = (instr & 0xffff) >> 8;
+		const int32_t offset = ( int32_t )instr >> 16;
+		union TaghaVal *const restrict rsp = ( union TaghaVal* )vm->osp;
+		const uintptr_t mem = rsp[src].uintptr + offset;
+		if( (mem+7 - vm->low_seg) > mem_bnds_diff || (mem & 7) != 0 ) {
+			vm->err = TaghaErrBadPtr;
+			return;
+		} else {
+			uint64_t *const ptr = ( uint64_t* )mem;
+			rsp[dst].uint64 = __atomic_fetch_xor(ptr, ( uint64_t )rsp[dst].uint64, __ATOMIC_SEQ_CST);
+			DISPATCH();
+		}
+	}
+	
+	exec_fence: { /// u8: opcode
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		DISPATCH();
+	}
+	
+	/// nop where the call can't be suspended.
+	exec_yield: { /// u8: opcode
+		if( _tagha_module_can_suspend(vm) ) {
+			vm->ip  = ( uintptr_t )pc.uint8;
+			vm->suspended.slot = NULL;
+			vm->err = TaghaErrSuspended;
+			return;
+		} else {
+			DISPATCH();
+		}
+	}
 }
\ No newline at end of file
@@ -16,6 +16,10 @@ extern "C" {
 #include "harbol_common_defines.h"
 #include "harbol_common_includes.h"
 #include "allocators/mempool/mempool.h"
+#include "allocators/tlsf/tlsf.h"
+#include "allocators/slab/slab.h"
+#include "allocators/vmem/vmem.h"
+#include "threads/threads.h"
 
 
 #define TAGHA_FLOAT32_DEFINED    /// allow tagha to use 32-bit floats
@@ -125,7 +129,20 @@ union TaghaPtr {
 	X(vadd)  X(vsub)  X(vmul)  X(vdiv)  X(vmod) X(vneg) \
 	X(vfadd) X(vfsub) X(vfmul) X(vfdiv) X(vfneg) \
 	X(vand)  X(vor)   X(vxor)  X(vshl)  X(vshr) X(vshar) X(vnot) \
-	X(vcmp)  X(vilt)  X(vile)  X(vult)  X(vule) X(vflt)  X(vfle)
+	X(vcmp)  X(vilt)  X(vile)  X(vult)  X(vule) X(vflt)  X(vfle) \
+	\
+	/** atomic ops, sequentially consistent. */ \
+	X(ald1)  X(ald2)  X(ald4)  X(ald8) \
+	X(ast1)  X(ast2)  X(ast4)  X(ast8) \
+	X(acas1) X(acas2) X(acas4) X(acas8) \
+	X(aadd1) X(aadd2) X(aadd4) X(aadd8) \
+	X(aand1) X(aand2) X(aand4) X(aand8) \
+	X(aor1)  X(aor2)  X(aor4)  X(aor8) \
+	X(axor1) X(axor2) X(axor4) X(axor8) \
+	X(fence) \
+	\
+	/** coroutines. */ \
+	X(yield)
 
 #define X(x) x,
 enum TaghaInstrSet { TAGHA_INSTR_SET MaxOps };
@@ -133,7 +150,19 @@ enum TaghaInstrSet { TAGHA_INSTR_SET MaxOps };
 
 
 enum {
-	TAGHA_MAGIC_VERIFIER = 0x7A6AC0DE    /// "tagha code"
+	TAGHA_MAGIC_VERIFIER        = 0x7A6AC0DE, /// "tagha code"
+	TAGHA_MODULE_VERSION_LEGACY = 1,          /// mem region is stored inside the module file.
+	TAGHA_MODULE_VERSION_NO_MEM = 2,          /// mem region is only described by size, allocated on load.
+	TAGHA_MODULE_VERSION_CHAINS = 3,          /// symbol hash index is stored as 32 bucket chains.
+	TAGHA_MODULE_VERSION        = 4,          /// symbol hash index is stored as open addressing slots.
+};
+
+/// module header flags.
+enum {
+	TAGHA_MODULE_HEAP_TLSF      = 1,          /// heap uses the TLSF allocator instead of the mempool. (not for legacy modules)
+	TAGHA_MODULE_HEAP_SLAB      = 2,          /// small allocations are served from slabs on top of the mempool. (not for legacy modules)
+	TAGHA_MODULE_HEAP_ALLOCATOR = TAGHA_MODULE_HEAP_TLSF | TAGHA_MODULE_HEAP_SLAB,
+	TAGHA_MODULE_HEAP_ARENA     = 4,          /// heap allocations made during a call are bump allocated & released when it returns. (not with TLSF)
 };
 struct TaghaModuleHeader {
 	uint32_t
@@ -148,7 +177,9 @@ struct TaghaModuleHeader {
 		vars_offset,
 		var_count,
 		mem_offset,
-		flags
+		flags,
+		version,    /// not present in legacy modules, their func table starts here.
+		index_offset /// symbol hash index offset (from base), not present before version 3.
 	;
 };
 
@@ -173,8 +204,10 @@ struct TaghaItemEntry {
  * 4 bytes: amount of funcs.
  * 4 bytes: var table offset (from base).
  * 4 bytes: amount of vars.
- * 4 bytes: mem region offset (from base).
- * 4 bytes: flags.
+ * 4 bytes: mem region offset (from base), end of var table since version 2.
+ * 4 bytes: flags. (TAGHA_MODULE_HEAP_* allocator selection)
+ * 4 bytes: format version. (absent in version 1 modules)
+ * 4 bytes: symbol index offset (from base). (absent before version 3)
  * ------------------------------ end of header --------------------------------
  * .funcs table.
  * n bytes: func table.
@@ -199,7 +232,15 @@ struct TaghaItemEntry {
  *     n bytes: global var string.
  *     n bytes: data. All 0 if not initialized in script code.
  * 
- * .mem region - taken control by the memory pool as both a stack and heap.
+ * .index table - since version 4, used in place by the loader.
+ * n bytes: func symbol index, `tagha_sym_slot_count(func count)` slots.
+ *     4 bytes: `tagha_sym_hash` of the func name.
+ *     4 bytes: index of the func, UINT32_MAX if the slot is empty.
+ * n bytes: global var symbol index, same layout as the func symbol index.
+ * 
+ * .mem region - NOT stored in the file since version 2, "total mem size" bytes are allocated on load.
+ *     the .vars table is copied in front of it so that globals + memory stay one contiguous segment.
+ *     taken control by the memory pool as both a stack and heap.
  *     | portion marshalled by the bifurcated stack:
  *     |    <- operand stack start
  *     |    ...
@@ -236,36 +277,123 @@ struct TaghaItem {
 typedef const struct TaghaItem *TaghaFunc;
 
 
-enum { TAGHA_SYM_BUCKETS = 32 };
+/// open addressing slot, hash is kept inline so probing rarely touches the keys.
+struct TaghaSymSlot {
+	uint32_t
+		hash,  /// `tagha_sym_hash` of the key.
+		index  /// index of the item, UINT32_MAX if slot is empty.
+	;
+};
+
 struct TaghaSymTable {
-	const char **keys;             /// array of string names of each item.
-	struct TaghaItem *table;       /// table of items.
+	const char **keys;                 /// array of string names of each item.
+	struct TaghaItem *table;           /// table of items.
+	const struct TaghaSymSlot *slots;  /// linear probing hash index, `mask + 1` slots.
 	size_t
-		len,                       /// table's len.
-		buckets[TAGHA_SYM_BUCKETS],/// hash index bucket for each index. SIZE_MAX if invalid.
-		*hashes,                   /// hash value for each item index.
-		*chain                     /// index chain to resolve collisions. SIZE_MAX if invalid.
+		len,                           /// table's len.
+		mask                           /// slot count - 1, slot count is a power of 2.
 	;
 };
 
+/// 32-bit FNV-1a with a murmur3 finalizer so the low bits used as slot index are well mixed.
+/// fixed width so hash indexes stored in module files are portable.
+static inline NO_NULL uint32_t tagha_sym_hash(const char key[static 1])
+{
+	uint32_t h = 2166136261u;
+	for( const uint8_t *restrict k = ( const uint8_t* )key; *k; k++ )
+		h = (h ^ *k) * 16777619u;
+	h ^= h >> 16; h *= 0x85EBCA6Bu;
+	h ^= h >> 13; h *= 0xC2B2AE35u;
+	h ^= h >> 16;
+	return h;
+}
+
+/// power of 2 slot count that keeps the load factor at or below 1/2.
+static inline uint32_t tagha_sym_slot_count(const uint32_t len)
+{
+	uint32_t count = 1;
+	while( count < len * 2 )
+		count <<= 1;
+	return count;
+}
+
 
 enum TaghaErrCode {
-	TaghaErrNone,      /// a-okay!
-	TaghaErrBadNative, /// missing native function. (native wasn't linked.)
-	TaghaErrBadExtern, /// missing extern function. (extern wasn't linked.)
-	TaghaErrOpStackOF, /// op stack overflow!
-	TaghaErrOpcodeOOB, /// opcode out of bounds!
-	TaghaErrBadPtr,    /// nil/invalid pointer.
-	TaghaErrBadFunc,   /// nil function.
+	TaghaErrNone,        /// a-okay!
+	TaghaErrBadNative,   /// missing native function. (native wasn't linked.)
+	TaghaErrBadExtern,   /// missing extern function. (extern wasn't linked.)
+	TaghaErrOpStackOF,   /// op stack overflow!
+	TaghaErrOpcodeOOB,   /// opcode out of bounds!
+	TaghaErrBadPtr,      /// nil/invalid pointer.
+	TaghaErrBadFunc,     /// nil function.
+	TaghaErrCallStackOF, /// call stack overflow!
+	TaghaErrSuspended,   /// not an error, the call is paused until `tagha_module_resume`.
 };
 
 
 /// Script/Module Structure.
+/// growable heaps reserve address space up to their limit & commit pages as the heap grows.
+#ifndef TAGHA_HEAP_GROW_STEP
+#	define TAGHA_HEAP_GROW_STEP    (64 * 1024)  /// least amount a heap grows by.
+#endif
+#ifndef TAGHA_HEAP_PAGE_ZERO
+#	define TAGHA_HEAP_PAGE_ZERO    (256 * 1024) /// heap blocks this big are zeroed by dropping their pages.
+#endif
+#ifndef TAGHA_HEAP_IDLE_CALLS
+#	define TAGHA_HEAP_IDLE_CALLS   256          /// host calls in a row without growing before the heap is trimmed.
+#endif
+
+struct TaghaHeapRange {
+	size_t
+		reserved,   /// bytes of address space reserved from `data`, 0 if `data` came from calloc.
+		committed,  /// bytes from `data` backed by memory.
+		min_size,   /// heap size on load, the heap never shrinks below it.
+		limit,      /// heap size can't go past this.
+		idle_calls  /// host calls since the heap last grew.
+	;
+	uint32_t load_flags; /// `TaghaModuleOpts` flags newly committed pages get.
+};
+
+/// load flags for the memory region holding a module's globals, stacks & heap.
+enum {
+	TAGHA_LOAD_HUGE_PAGES = 1 << 0,  /// back it with huge pages where available.
+	TAGHA_LOAD_PREFAULT   = 1 << 1,  /// fault its pages in up front.
+	TAGHA_LOAD_MLOCK      = 1 << 2,  /// lock its pages in RAM.
+	TAGHA_LOAD_CONCURRENT_HEAP = 1 << 3, /// heap is allocated from by several host threads at once. (not for TLSF, turns off slabs & arenas)
+};
+
+/// load options, zeroed options load a module as its header describes it.
+struct TaghaModuleOpts {
+	size_t heap_limit; /// lets the heap grow past `$heap_size` up to this many bytes. (not for TLSF or legacy modules)
+	uint32_t flags;    /// `TAGHA_LOAD_*` flags. (not for legacy modules)
+};
+
+/// a module's calls waiting on a `struct TaghaSched`.
+struct TaghaTaskQueue {
+	volatile size_t inbox;   /// `struct TaghaTask*` list, newest first.
+	volatile size_t pending; /// calls submitted & not yet run, the module sits in one worker's deque while there are any.
+	volatile size_t home;    /// 1 + worker that last ran the module, 0 if none has.
+	struct TaghaModule *prev, *next; /// links in a worker's deque.
+};
+
+/// host call state a suspended call gets back once it's resumed to its end.
+struct TaghaSuspension {
+	const struct TaghaSymTable *funcs, *vars;
+	uintptr_t csp, lr;
+	uintptr_t arena;  /// arena mark the call's scope rewinds to.
+	size_t    bytes;  /// opstack bytes the call pushed.
+	union TaghaVal *slot; /// return slot of the native that suspended the call, NULL after a `yield`.
+};
+
 struct TaghaModule {
 	struct HarbolMemPool heap;   /// holds ALL memory in a script.
-	const struct TaghaSymTable *funcs, *vars;
+	struct HarbolTLSF    tlsf;   /// holds ALL memory instead of `heap` if module has `TAGHA_MODULE_HEAP_TLSF`.
+	struct HarbolSlabAlloc slabs; /// front-end of `heap` if module has `TAGHA_MODULE_HEAP_SLAB`.
+	const struct TaghaSymTable *funcs, *vars;         /// tables of the running code, another module's during an extern call.
+	const struct TaghaSymTable *own_funcs, *own_vars; /// the module's own tables, extern calls into it switch to these.
 	uintptr_t
 		script,     /// ptr to base address of script (uint8_t*)
+		data,       /// ptr to data segment allocated on load, NIL for legacy modules (uint8_t*)
 		ip,         /// instruction ptr (uint8_t*)
 		low_seg,    /// lower  memory segment (uint8_t*)
 		high_seg,   /// higher memory segment (uint8_t*)
@@ -276,13 +404,48 @@ struct TaghaModule {
 		lr          /// link register.
 	;
 	size_t opstack_size, callstack_size, vec_len, elem_len;
+	struct TaghaHeapRange heap_range;
+	uintptr_t heap_mark;   /// heap's cache offset once loaded, `tagha_module_heap_reset` rewinds to it.
+	size_t    call_depth;  /// host calls in progress, arena scopes & heap trimming go by the outermost.
+	struct TaghaModule *parent; /// module a thread context runs for, NULL for modules.
+	volatile size_t workers;    /// thread contexts still running on this module, changed atomically.
+	struct HarbolThreadPool *pool; /// host's threads for `parallel_for`, NULL runs it on the calling thread.
+	struct TaghaTaskQueue queue;
+	struct TaghaSuspension suspended; /// valid while `err` is `TaghaErrSuspended`.
 	uint32_t  flags;
 	int       err, cond;
 };
 
+/// a module function running on its own thread, see `tagha_module_spawn`.
+struct TaghaWorker {
+	struct TaghaModule  ctxt;   /// execution context, shares the module's code, data & heap.
+	struct HarbolThread thread;
+	TaghaFunc           func;
+	union TaghaVal      result;
+	size_t              args;
+	bool                ok;
+	union TaghaVal      params[];
+};
+
+/// snapshot of a module's heap, see `tagha_module_heap_stats`.
+struct TaghaHeapStats {
+	size_t
+		capacity,      /// bytes managed by the heap allocator.
+		in_use,        /// bytes held by allocations, stacks & symbol tables included.
+		peak_in_use,   /// highest `in_use` seen on allocation.
+		free,          /// capacity - in_use.
+		largest_free,  /// largest free block, bounds the biggest allocation that can still succeed.
+		allocs[HARBOL_STATS_BUCKETS], /// allocations per power of 2 block size, block headers included.
+		frees[HARBOL_STATS_BUCKETS]
+	;
+	double fragmentation; /// 1 - largest_free / free, 0 when all free memory is one block.
+};
+
 /// Module Constructors.
 TAGHA_EXPORT NO_NULL struct TaghaModule *tagha_module_new_from_file(const char filename[]);
 TAGHA_EXPORT NO_NULL struct TaghaModule *tagha_module_new_from_buffer(uint8_t buffer[]);
+TAGHA_EXPORT NO_NULL struct TaghaModule *tagha_module_new_from_file_opts(const char filename[], const struct TaghaModuleOpts *opts);
+TAGHA_EXPORT NO_NULL struct TaghaModule *tagha_module_new_from_buffer_opts(uint8_t buffer[], const struct TaghaModuleOpts *opts);
 
 /// Module Destructors.
 TAGHA_EXPORT bool tagha_module_clear(struct TaghaModule *module);
@@ -295,13 +458,39 @@ TAGHA_EXPORT NEVER_NULL(1,2) bool tagha_module_invoke(struct TaghaModule *module
 
 TAGHA_EXPORT NEVER_NULL(1) int tagha_module_run(struct TaghaModule *module, size_t argc, const union TaghaVal argv[]);
 
+/// Coroutine API.
+/// called by natives, pauses the script once the native returns. false if the call can't be suspended.
+TAGHA_EXPORT NO_NULL bool tagha_module_suspend(struct TaghaModule *module);
+/// continues a suspended call, false if it suspended again or failed.
+TAGHA_EXPORT NEVER_NULL(1) bool tagha_module_resume(struct TaghaModule *module, union TaghaVal *retval);
+/// same but 'result' replaces what the suspending native returned, for natives that finish asynchronously.
+TAGHA_EXPORT NEVER_NULL(1) bool tagha_module_resume_with(struct TaghaModule *module, union TaghaVal result, union TaghaVal *retval);
+TAGHA_EXPORT NO_NULL bool tagha_module_suspended(const struct TaghaModule *module);
+
+/// Threads API.
+/// runs 'func' on a new thread with its own stacks, NULL if the module's heap can't be shared.
+TAGHA_EXPORT NEVER_NULL(1,2) struct TaghaWorker *tagha_module_spawn(struct TaghaModule *module, TaghaFunc func, size_t args, const union TaghaVal params[]);
+/// waits for the worker & frees it, returns its error code.
+TAGHA_EXPORT NEVER_NULL(1) int tagha_worker_join(struct TaghaWorker *worker, union TaghaVal *retval);
+/// runs 'func(lo, hi)' over [begin, end) in chunks of 'grain' on the module's pool & the calling thread.
+TAGHA_EXPORT NEVER_NULL(1,2) bool tagha_module_parallel_for(struct TaghaModule *module, TaghaFunc func, size_t begin, size_t end, size_t grain);
+TAGHA_EXPORT NEVER_NULL(1) void tagha_module_set_pool(struct TaghaModule *module, struct HarbolThreadPool *pool);
+/// `thread_spawn`, `thread_join` & `parallel_for` natives for scripts.
+TAGHA_EXPORT extern const struct TaghaNative tagha_thread_natives[];
+
 /// Runtime Data API.
 TAGHA_EXPORT NO_NULL void *tagha_module_get_var(const struct TaghaModule *module, const char name[]);
 TAGHA_EXPORT NO_NULL TaghaFunc tagha_module_get_func(const struct TaghaModule *module, const char name[]);
 TAGHA_EXPORT NO_NULL uint32_t tagha_module_get_flags(const struct TaghaModule *module);
 
 TAGHA_EXPORT NO_NULL uintptr_t tagha_module_heap_alloc(struct TaghaModule *module, size_t size);
+TAGHA_EXPORT NEVER_NULL(1) uintptr_t tagha_module_heap_realloc(struct TaghaModule *module, uintptr_t ptr, size_t size);
 TAGHA_EXPORT NO_NULL bool tagha_module_heap_free(struct TaghaModule *module, uintptr_t ptr);
+TAGHA_EXPORT NO_NULL uintptr_t tagha_module_heap_alloc_persistent(struct TaghaModule *module, size_t size);
+TAGHA_EXPORT NO_NULL uintptr_t tagha_module_heap_alloc_uninit(struct TaghaModule *module, size_t size);
+TAGHA_EXPORT NO_NULL size_t tagha_module_heap_trim(struct TaghaModule *module);
+TAGHA_EXPORT NO_NULL bool tagha_module_heap_reset(struct TaghaModule *module, bool zero);
+TAGHA_EXPORT NO_NULL void tagha_module_heap_stats(const struct TaghaModule *module, struct TaghaHeapStats *stats);
 
 /// Error API.
 TAGHA_EXPORT NO_NULL NONNULL_RET const char *tagha_module_get_err(const struct TaghaModule *module);
@@ -312,12 +501,87 @@ TAGHA_EXPORT NO_NULL void tagha_module_link_natives(struct TaghaModule *module,
 TAGHA_EXPORT NO_NULL bool tagha_module_link_ptr(struct TaghaModule *module, const char name[], uintptr_t ptr);
 TAGHA_EXPORT NO_NULL void tagha_module_link_module(struct TaghaModule *module, const struct TaghaModule *lib);
 
-/** I like Golang.
-	type TaghaSys struct {
-		modules map[string]*TaghaModule // map[string]TaghaFunc
-		natives map[string]TaghaCFunc
-	}
- */
+/// Native Registry API.
+/// process-wide, each native gets a stable id the first time its name is registered.
+/// registering isn't thread-safe & native names must outlive the registry.
+#define TAGHA_NATIVE_INVALID_ID    UINT32_MAX
+TAGHA_EXPORT NO_NULL uint32_t tagha_native_register(const char name[], TaghaCFunc *cfunc);
+TAGHA_EXPORT NO_NULL bool tagha_native_register_all(const struct TaghaNative natives[]);
+TAGHA_EXPORT NO_NULL uint32_t tagha_native_get_id(const char name[]);
+TAGHA_EXPORT TaghaCFunc *tagha_native_get(uint32_t id);
+TAGHA_EXPORT void tagha_native_registry_clear(void);
+
+/// binds every native the module imports in one pass, unbound natives are also looked up on their first call.
+TAGHA_EXPORT NO_NULL bool tagha_module_link_registry(struct TaghaModule *module);
+
+
+/// Module Registry.
+/// loads every module once by name, links all loaded modules' externs with one another
+/// & binds their natives from the native registry.
+struct TaghaSys {
+	struct TaghaModule **modules;
+	char **names;                 /// owned copies of the names modules were loaded by.
+	struct TaghaSymSlot *slots;   /// name hash -> module index.
+	size_t len, cap, mask;
+	struct TaghaModuleOpts opts;  /// every module is loaded with these.
+};
+
+TAGHA_EXPORT struct TaghaSys tagha_sys_create(void);
+TAGHA_EXPORT NO_NULL bool tagha_sys_clear(struct TaghaSys *sys);
+
+TAGHA_EXPORT NO_NULL struct TaghaModule *tagha_sys_load_module(struct TaghaSys *sys, const char filename[]);
+TAGHA_EXPORT NO_NULL struct TaghaModule *tagha_sys_get_module(const struct TaghaSys *sys, const char filename[]);
+TAGHA_EXPORT NO_NULL TaghaFunc tagha_sys_get_func(const struct TaghaSys *sys, const char name[]);
+
+
+/// Scheduler.
+/// worker threads running module calls as tasks, each with a deque of modules that have calls waiting.
+/// a module runs on one worker at a time & goes back to the worker that last ran it,
+/// idle workers steal modules from the other deques.
+typedef void TaghaTaskCallback(void *data, struct TaghaModule *module, int err, union TaghaVal result);
+
+struct TaghaSched;
+struct TaghaTask {
+	struct TaghaTask  *next;
+	struct TaghaSched *sched;
+	TaghaFunc          func;
+	TaghaTaskCallback *on_done;  /// NULL for tasks waited on with `tagha_task_wait`.
+	void              *data;
+	union TaghaVal     result;
+	volatile size_t    done;
+	int                err;
+	size_t             args;
+	union TaghaVal     params[];
+};
+
+struct TaghaSchedWorker {
+	struct HarbolThread  thread;
+	struct HarbolMutex   lock;
+	struct TaghaModule  *top, *bottom; /// the worker takes from the bottom, thieves from the top.
+	struct TaghaSched   *sched;
+	size_t               index;
+};
+
+struct TaghaSched {
+	struct HarbolMutex       lock;
+	struct HarbolCond        wake, done;
+	struct TaghaSchedWorker *workers;
+	size_t                   len;
+	volatile size_t          ready, sleepers, quit;
+};
+
+TAGHA_EXPORT NO_NULL bool tagha_sched_init(struct TaghaSched *sched, size_t threads);
+/// runs what's still queued, then stops & joins the workers.
+TAGHA_EXPORT NO_NULL void tagha_sched_clear(struct TaghaSched *sched);
+
+/// queues 'func(params)' on the module, the task has to be waited on.
+TAGHA_EXPORT NEVER_NULL(1,2,3) struct TaghaTask *tagha_sched_submit(struct TaghaSched *sched, struct TaghaModule *module, TaghaFunc func, size_t args, const union TaghaVal params[]);
+/// queues 'func(params)' on the module, 'on_done' gets the result on the worker thread.
+TAGHA_EXPORT NEVER_NULL(1,2,3,6) bool tagha_sched_post(struct TaghaSched *sched, struct TaghaModule *module, TaghaFunc func, size_t args, const union TaghaVal params[], TaghaTaskCallback *on_done, void *data);
+
+TAGHA_EXPORT NO_NULL bool tagha_task_done(const struct TaghaTask *task);
+/// waits for the task & frees it, returns its error code.
+TAGHA_EXPORT NEVER_NULL(1) int tagha_task_wait(struct TaghaTask *task, union TaghaVal *retval);
 
 #ifdef __cplusplus
 } /// extern "C"
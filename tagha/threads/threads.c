@@ -0,0 +1,339 @@
+#include "threads.h"
+
+#ifdef OS_WINDOWS
+#	define HARBOL_LIB
+#	include <windows.h>
+#	include <process.h>
+#endif
+
+
+HARBOL_EXPORT bool harbol_mutex_init(struct HarbolMutex *const mutex)
+{
+#ifdef OS_WINDOWS
+	InitializeSRWLock(( PSRWLOCK )&mutex->lock);
+	return true;
+#else
+	return pthread_mutex_init(&mutex->lock, NULL)==0;
+#endif
+}
+
+HARBOL_EXPORT void harbol_mutex_lock(struct HarbolMutex *const mutex)
+{
+#ifdef OS_WINDOWS
+	AcquireSRWLockExclusive(( PSRWLOCK )&mutex->lock);
+#else
+	pthread_mutex_lock(&mutex->lock);
+#endif
+}
+
+HARBOL_EXPORT void harbol_mutex_unlock(struct HarbolMutex *const mutex)
+{
+#ifdef OS_WINDOWS
+	ReleaseSRWLockExclusive(( PSRWLOCK )&mutex->lock);
+#else
+	pthread_mutex_unlock(&mutex->lock);
+#endif
+}
+
+HARBOL_EXPORT void harbol_mutex_destroy(struct HarbolMutex *const mutex)
+{
+#ifdef OS_WINDOWS
+	/// SRW locks need no cleanup.
+	( void )mutex;
+#else
+	pthread_mutex_destroy(&mutex->lock);
+#endif
+}
+
+
+HARBOL_EXPORT bool harbol_cond_init(struct HarbolCond *const cond)
+{
+#ifdef OS_WINDOWS
+	InitializeConditionVariable(( PCONDITION_VARIABLE )&cond->cond);
+	return true;
+#else
+	return pthread_cond_init(&cond->cond, NULL)==0;
+#endif
+}
+
+HARBOL_EXPORT void harbol_cond_wait(struct HarbolCond *const cond, struct HarbolMutex *const mutex)
+{
+#ifdef OS_WINDOWS
+	SleepConditionVariableSRW(( PCONDITION_VARIABLE )&cond->cond, ( PSRWLOCK )&mutex->lock, INFINITE, 0);
+#else
+	pthread_cond_wait(&cond->cond, &mutex->lock);
+#endif
+}
+
+HARBOL_EXPORT void harbol_cond_signal(struct HarbolCond *const cond)
+{
+#ifdef OS_WINDOWS
+	WakeConditionVariable(( PCONDITION_VARIABLE )&cond->cond);
+#else
+	pthread_cond_signal(&cond->cond);
+#endif
+}
+
+HARBOL_EXPORT void harbol_cond_broadcast(struct HarbolCond *const cond)
+{
+#ifdef OS_WINDOWS
+	WakeAllConditionVariable(( PCONDITION_VARIABLE )&cond->cond);
+#else
+	pthread_cond_broadcast(&cond->cond);
+#endif
+}
+
+HARBOL_EXPORT void harbol_cond_destroy(struct HarbolCond *const cond)
+{
+#ifdef OS_WINDOWS
+	/// condition variables need no cleanup.
+	( void )cond;
+#else
+	pthread_cond_destroy(&cond->cond);
+#endif
+}
+
+
+#ifdef OS_WINDOWS
+static unsigned __stdcall _harbol_thread_start(void *const arg)
+#else
+static void *_harbol_thread_start(void *const arg)
+#endif
+{
+	struct HarbolThread *const thread = arg;
+	thread->result = (*thread->func)(thread->arg);
+#ifdef OS_WINDOWS
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+HARBOL_EXPORT bool harbol_thread_create(struct HarbolThread *const restrict thread, HarbolThreadFunc *const func, void *const arg)
+{
+	thread->func   = func;
+	thread->arg    = arg;
+	thread->result = NULL;
+#ifdef OS_WINDOWS
+	thread->handle = ( void* )_beginthreadex(NULL, 0, &_harbol_thread_start, thread, 0, NULL);
+	return thread->handle != NULL;
+#else
+	return pthread_create(&thread->handle, NULL, &_harbol_thread_start, thread)==0;
+#endif
+}
+
+HARBOL_EXPORT void *harbol_thread_join(struct HarbolThread *const thread)
+{
+#ifdef OS_WINDOWS
+	WaitForSingleObject(( HANDLE )thread->handle, INFINITE);
+	CloseHandle(( HANDLE )thread->handle);
+#else
+	pthread_join(thread->handle, NULL);
+#endif
+	return thread->result;
+}
+
+
+/// bit 'i' of the words is set while a live thread holds slot 'i'.
+static volatile size_t _slot_lock = 0;
+static size_t *_slot_words = NULL, _slot_word_count = 0;
+#ifdef OS_WINDOWS
+static DWORD _slot_key = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t _slot_key;
+#endif
+static bool _slot_key_made = false;
+
+static void _harbol_slot_lock(void)
+{
+	while( !harbol_atomic_cas_size(&_slot_lock, 0, 1) );
+}
+
+static void _harbol_slot_unlock(void)
+{
+	harbol_atomic_store_size(&_slot_lock, 0);
+}
+
+/// runs as the thread exits, its slot goes to the next thread that asks for one.
+#ifdef OS_WINDOWS
+static void WINAPI _harbol_slot_release(void *const val)
+#else
+static void _harbol_slot_release(void *const val)
+#endif
+{
+	const size_t slot = ( size_t )( uintptr_t )val - 1;
+	const size_t bits = sizeof *_slot_words * CHAR_BIT;
+	_harbol_slot_lock();
+	_slot_words[slot / bits] &= ~(( size_t )1 << (slot % bits));
+	_harbol_slot_unlock();
+}
+
+/// lowest free slot, SIZE_MAX if there's no memory to track another.
+static size_t _harbol_slot_acquire(void)
+{
+	const size_t bits = sizeof *_slot_words * CHAR_BIT;
+	size_t slot = SIZE_MAX;
+	_harbol_slot_lock();
+	if( !_slot_key_made ) {
+#ifdef OS_WINDOWS
+		_slot_key = FlsAlloc(&_harbol_slot_release);
+		_slot_key_made = _slot_key != FLS_OUT_OF_INDEXES;
+#else
+		_slot_key_made = pthread_key_create(&_slot_key, &_harbol_slot_release)==0;
+#endif
+	}
+	
+	for( size_t w=0; w<_slot_word_count && slot==SIZE_MAX; w++ ) {
+		const size_t free_bits = ~_slot_words[w];
+		if( free_bits==0 )
+			continue;
+		
+		size_t bit = 0;
+		while( !(free_bits & (( size_t )1 << bit)) )
+			bit++;
+		_slot_words[w] |= ( size_t )1 << bit;
+		slot = w * bits + bit;
+	}
+	if( slot==SIZE_MAX ) {
+		size_t *const words = realloc(_slot_words, sizeof *words * (_slot_word_count + 1));
+		if( words != NULL ) {
+			_slot_words = words;
+			_slot_words[_slot_word_count] = 1;
+			slot = _slot_word_count++ * bits;
+		}
+	}
+	
+	/// without the exit hook the slot stays taken for good.
+	if( slot != SIZE_MAX && _slot_key_made ) {
+#ifdef OS_WINDOWS
+		FlsSetValue(_slot_key, ( void* )( uintptr_t )(slot + 1));
+#else
+		pthread_setspecific(_slot_key, ( void* )( uintptr_t )(slot + 1));
+#endif
+	}
+	_harbol_slot_unlock();
+	return slot;
+}
+
+HARBOL_EXPORT size_t harbol_thread_slot(void)
+{
+	/// 0 until the thread asks, stored off by one.
+	static HARBOL_THREAD_LOCAL size_t slot = 0;
+	if( slot==0 ) {
+		const size_t taken = _harbol_slot_acquire();
+		if( taken==SIZE_MAX )
+			return SIZE_MAX;
+		slot = taken + 1;
+	}
+	return slot - 1;
+}
+
+
+/// pool the calling thread belongs to.
+static HARBOL_THREAD_LOCAL const struct HarbolThreadPool *_pool_of_thread = NULL;
+
+static void *_harbol_pool_loop(void *const arg)
+{
+	struct HarbolPoolThread *const self = arg;
+	struct HarbolThreadPool *const pool = self->pool;
+	_pool_of_thread = pool;
+	
+	/// jobs can be started before the thread first gets the lock, it counts from the pool's first.
+	size_t seen = 0;
+	harbol_mutex_lock(&pool->lock);
+	for( ;; ) {
+		while( pool->generation==seen && !pool->quit )
+			harbol_cond_wait(&pool->start, &pool->lock);
+		if( pool->quit )
+			break;
+		
+		seen = pool->generation;
+		HarbolPoolFunc *const func = pool->func;
+		void *const job = pool->arg;
+		harbol_mutex_unlock(&pool->lock);
+		(*func)(job, self->index);
+		harbol_mutex_lock(&pool->lock);
+		if( --pool->running==0 )
+			harbol_cond_broadcast(&pool->done);
+	}
+	harbol_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+HARBOL_EXPORT bool harbol_thread_pool_init(struct HarbolThreadPool *const pool, const size_t threads)
+{
+	*pool = (struct HarbolThreadPool){ 0 };
+	if( !harbol_mutex_init(&pool->lock) )
+		return false;
+	else if( !harbol_cond_init(&pool->start) ) {
+		harbol_mutex_destroy(&pool->lock);
+		return false;
+	} else if( !harbol_cond_init(&pool->done) ) {
+		harbol_cond_destroy(&pool->start);
+		harbol_mutex_destroy(&pool->lock);
+		return false;
+	}
+	
+	pool->threads = ( threads > 0 ) ? calloc(threads, sizeof *pool->threads) : NULL;
+	if( threads > 0 && pool->threads==NULL ) {
+		harbol_thread_pool_clear(pool);
+		return false;
+	}
+	for( size_t i=0; i<threads; i++ ) {
+		pool->threads[i].pool  = pool;
+		pool->threads[i].index = i;
+		if( !harbol_thread_create(&pool->threads[i].thread, &_harbol_pool_loop, &pool->threads[i]) ) {
+			harbol_thread_pool_clear(pool);
+			return false;
+		}
+		pool->len++;
+	}
+	return true;
+}
+
+HARBOL_EXPORT void harbol_thread_pool_clear(struct HarbolThreadPool *const pool)
+{
+	harbol_mutex_lock(&pool->lock);
+	pool->quit = true;
+	harbol_cond_broadcast(&pool->start);
+	harbol_mutex_unlock(&pool->lock);
+	for( size_t i=0; i<pool->len; i++ )
+		harbol_thread_join(&pool->threads[i].thread);
+	
+	free(pool->threads);
+	harbol_cond_destroy(&pool->done);
+	harbol_cond_destroy(&pool->start);
+	harbol_mutex_destroy(&pool->lock);
+	*pool = (struct HarbolThreadPool){ 0 };
+}
+
+HARBOL_EXPORT bool harbol_thread_pool_start(struct HarbolThreadPool *const pool, HarbolPoolFunc *const func, void *const arg)
+{
+	/// a pool thread waiting on its own pool would never be woken.
+	if( pool->len==0 || harbol_thread_pool_owns_thread(pool) )
+		return false;
+	
+	harbol_mutex_lock(&pool->lock);
+	while( pool->running != 0 )
+		harbol_cond_wait(&pool->done, &pool->lock);
+	pool->func    = func;
+	pool->arg     = arg;
+	pool->running = pool->len;
+	pool->generation++;
+	harbol_cond_broadcast(&pool->start);
+	harbol_mutex_unlock(&pool->lock);
+	return true;
+}
+
+HARBOL_EXPORT void harbol_thread_pool_wait(struct HarbolThreadPool *const pool)
+{
+	harbol_mutex_lock(&pool->lock);
+	while( pool->running != 0 )
+		harbol_cond_wait(&pool->done, &pool->lock);
+	harbol_mutex_unlock(&pool->lock);
+}
+
+HARBOL_EXPORT bool harbol_thread_pool_owns_thread(const struct HarbolThreadPool *const pool)
+{
+	return _pool_of_thread==pool;
+}
@@ -0,0 +1,187 @@
+#ifndef HARBOL_THREADS_INCLUDED
+#	define HARBOL_THREADS_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../harbol_common_defines.h"
+#include "../harbol_common_includes.h"
+
+#ifdef OS_WINDOWS
+#	include <intrin.h>
+#else
+#	include <pthread.h>
+#endif
+
+
+/**
+ * Thin layer over the OS' threads.
+ * pthreads everywhere but Windows, which uses its own threads & slim reader/writer locks.
+ */
+#if defined(COMPILER_MSVC)
+#	define HARBOL_THREAD_LOCAL    __declspec(thread)
+#else
+#	define HARBOL_THREAD_LOCAL    __thread
+#endif
+
+struct HarbolMutex {
+#ifdef OS_WINDOWS
+	void *lock; /// SRWLOCK, same size as a pointer.
+#else
+	pthread_mutex_t lock;
+#endif
+};
+
+struct HarbolCond {
+#ifdef OS_WINDOWS
+	void *cond; /// CONDITION_VARIABLE, same size as a pointer.
+#else
+	pthread_cond_t cond;
+#endif
+};
+
+typedef void *HarbolThreadFunc(void *arg);
+
+struct HarbolThread {
+#ifdef OS_WINDOWS
+	void *handle;
+#else
+	pthread_t handle;
+#endif
+	HarbolThreadFunc *func;
+	void *arg, *result;
+};
+
+
+HARBOL_EXPORT NO_NULL bool harbol_mutex_init(struct HarbolMutex *mutex);
+HARBOL_EXPORT NO_NULL void harbol_mutex_lock(struct HarbolMutex *mutex);
+HARBOL_EXPORT NO_NULL void harbol_mutex_unlock(struct HarbolMutex *mutex);
+HARBOL_EXPORT NO_NULL void harbol_mutex_destroy(struct HarbolMutex *mutex);
+
+/// 'thread' has to stay put until it's joined.
+HARBOL_EXPORT NEVER_NULL(1,2) bool harbol_thread_create(struct HarbolThread *thread, HarbolThreadFunc *func, void *arg);
+HARBOL_EXPORT NO_NULL void *harbol_thread_join(struct HarbolThread *thread);
+
+HARBOL_EXPORT NO_NULL bool harbol_cond_init(struct HarbolCond *cond);
+/// 'mutex' has to be locked, it's unlocked while waiting. wakeups can be spurious.
+HARBOL_EXPORT NO_NULL void harbol_cond_wait(struct HarbolCond *cond, struct HarbolMutex *mutex);
+HARBOL_EXPORT NO_NULL void harbol_cond_signal(struct HarbolCond *cond);
+HARBOL_EXPORT NO_NULL void harbol_cond_broadcast(struct HarbolCond *cond);
+HARBOL_EXPORT NO_NULL void harbol_cond_destroy(struct HarbolCond *cond);
+
+/// small number unique among live threads, the lowest one free when the thread first asks. exited threads give theirs back.
+/// SIZE_MAX if out of memory.
+HARBOL_EXPORT size_t harbol_thread_slot(void);
+
+
+/// sequentially consistent `size_t` atomics.
+static inline NO_NULL size_t harbol_atomic_load_size(volatile size_t *const ptr)
+{
+#if defined(COMPILER_MSVC)
+	return ( size_t )_InterlockedOr64(( volatile long long* )ptr, 0);
+#else
+	return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline NO_NULL void harbol_atomic_store_size(volatile size_t *const ptr, const size_t val)
+{
+#if defined(COMPILER_MSVC)
+	_InterlockedExchange64(( volatile long long* )ptr, ( long long )val);
+#else
+	__atomic_store_n(ptr, val, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/// returns the old value.
+static inline NO_NULL size_t harbol_atomic_fetch_add_size(volatile size_t *const ptr, const size_t val)
+{
+#if defined(COMPILER_MSVC)
+	return ( size_t )_InterlockedExchangeAdd64(( volatile long long* )ptr, ( long long )val);
+#else
+	return __atomic_fetch_add(ptr, val, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/// returns the old value.
+static inline NO_NULL size_t harbol_atomic_exchange_size(volatile size_t *const ptr, const size_t val)
+{
+#if defined(COMPILER_MSVC)
+	return ( size_t )_InterlockedExchange64(( volatile long long* )ptr, ( long long )val);
+#else
+	return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/// stores 'desired' if '*ptr' holds 'expected', returns whether it did.
+static inline NO_NULL bool harbol_atomic_cas_size(volatile size_t *const ptr, size_t expected, const size_t desired)
+{
+#if defined(COMPILER_MSVC)
+	return ( size_t )_InterlockedCompareExchange64(( volatile long long* )ptr, ( long long )desired, ( long long )expected)==expected;
+#else
+	return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/// pointer sized fields shared between threads.
+static inline NO_NULL uintptr_t harbol_atomic_load_uintptr(volatile uintptr_t *const ptr)
+{
+#if defined(COMPILER_MSVC)
+	return ( uintptr_t )_InterlockedOr64(( volatile long long* )ptr, 0);
+#else
+	return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline NO_NULL void harbol_atomic_store_uintptr(volatile uintptr_t *const ptr, const uintptr_t val)
+{
+#if defined(COMPILER_MSVC)
+	_InterlockedExchange64(( volatile long long* )ptr, ( long long )val);
+#else
+	__atomic_store_n(ptr, val, __ATOMIC_SEQ_CST);
+#endif
+}
+/********************************************************************/
+
+
+/**
+ * Fixed set of threads that all run the same job.
+ * the starting thread can do its share before waiting for the rest.
+ */
+typedef void HarbolPoolFunc(void *arg, size_t index);
+
+struct HarbolThreadPool;
+struct HarbolPoolThread {
+	struct HarbolThread      thread;
+	struct HarbolThreadPool *pool;
+	size_t                   index;
+};
+
+struct HarbolThreadPool {
+	struct HarbolMutex       lock;
+	struct HarbolCond        start, done;
+	struct HarbolPoolThread *threads;
+	HarbolPoolFunc          *func;
+	void                    *arg;
+	size_t                   len, running, generation;
+	bool                     quit;
+};
+
+HARBOL_EXPORT NO_NULL bool harbol_thread_pool_init(struct HarbolThreadPool *pool, size_t threads);
+/// stops & joins the threads, no job may be running.
+HARBOL_EXPORT NO_NULL void harbol_thread_pool_clear(struct HarbolThreadPool *pool);
+
+/// runs 'func(arg, i)' on every pool thread 'i', waits for an earlier job first.
+/// false if the pool has no threads or the caller is one of them, nothing was started then.
+HARBOL_EXPORT NEVER_NULL(1,2) bool harbol_thread_pool_start(struct HarbolThreadPool *pool, HarbolPoolFunc *func, void *arg);
+/// waits for the started job to finish on every thread.
+HARBOL_EXPORT NO_NULL void harbol_thread_pool_wait(struct HarbolThreadPool *pool);
+HARBOL_EXPORT NO_NULL bool harbol_thread_pool_owns_thread(const struct HarbolThreadPool *pool);
+/********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HARBOL_THREADS_INCLUDED */
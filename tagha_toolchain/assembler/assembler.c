@@ -66,7 +66,7 @@ static struct {
 	struct HarbolString src, outfile, lexeme, *active_label;
 	const char *iter;
 	size_t line, pc;
-	uint32_t callstacksize, opstacksize, heapsize;
+	uint32_t callstacksize, opstacksize, heapsize, flags;
 	bool err : 1;
 } tagha_asm;
 
@@ -208,6 +208,40 @@ static void tagha_asm_parse_heapsize(void)
 #endif
 }
 
+/// $heap_allocator mempool|tlsf|slab
+static void tagha_asm_parse_heap_allocator(void)
+{
+	_tagha_asm_skip_whitespace();
+	struct HarbolString allocator = harbol_string_create("");
+	const char *end = NULL;
+	if( !lex_id(tagha_asm.iter, &end, &allocator) ) {
+		_tagha_asm_err(tagha_asm.outfile.cstr, "error", tagha_asm.line, 0, "heap allocator directive requires an allocator name!");
+	} else {
+		tagha_asm.iter = end;
+		tagha_asm.flags &= ~TAGHA_MODULE_HEAP_ALLOCATOR;
+		if( !harbol_string_cmpcstr(&allocator, "tlsf") )
+			tagha_asm.flags |= TAGHA_MODULE_HEAP_TLSF;
+		else if( !harbol_string_cmpcstr(&allocator, "slab") )
+			tagha_asm.flags |= TAGHA_MODULE_HEAP_SLAB;
+		else if( harbol_string_cmpcstr(&allocator, "mempool") ) {
+			_tagha_asm_err(tagha_asm.outfile.cstr, "error", tagha_asm.line, 0, "unknown heap allocator: '%s', expected 'mempool', 'tlsf' or 'slab'.", allocator.cstr);
+		}
+	}
+	harbol_string_clear(&allocator);
+#ifdef TAGHA_ASM_DEBUG
+	printf("module flags = %u\n", tagha_asm.flags);
+#endif
+}
+
+/// $heap_arena
+static void tagha_asm_parse_heap_arena(void)
+{
+	tagha_asm.flags |= TAGHA_MODULE_HEAP_ARENA;
+#ifdef TAGHA_ASM_DEBUG
+	printf("module flags = %u\n", tagha_asm.flags);
+#endif
+}
+
 /// $global varname bytes ...
 static void tagha_asm_parse_global(void)
 {
@@ -428,6 +462,10 @@ static void tagha_asm_assemble(void)
 				tagha_asm_parse_callstacksize();
 			} else if( !harbol_string_cmpcstr(&tagha_asm.lexeme, "$heap_size") ) {
 				tagha_asm_parse_heapsize();
+			} else if( !harbol_string_cmpcstr(&tagha_asm.lexeme, "$heap_allocator") ) {
+				tagha_asm_parse_heap_allocator();
+			} else if( !harbol_string_cmpcstr(&tagha_asm.lexeme, "$heap_arena") ) {
+				tagha_asm_parse_heap_arena();
 			} else if( !harbol_string_cmpcstr(&tagha_asm.lexeme, "$global") ) {
 				tagha_asm_parse_global();
 			} else if( !harbol_string_cmpcstr(&tagha_asm.lexeme, "$native") ) {
@@ -790,7 +828,13 @@ static void tagha_asm_assemble(void)
 					
 					/// two uint8 registers + int16 offset.  
 					case lea:
-					case ld1: case ld2: case ld4: case ld8: case ldu1: case ldu2: case ldu4: {
+					case ld1: case ld2: case ld4: case ld8: case ldu1: case ldu2: case ldu4:
+					case ald1: case ald2: case ald4: case ald8:
+					case acas1: case acas2: case acas4: case acas8:
+					case aadd1: case aadd2: case aadd4: case aadd8:
+					case aand1: case aand2: case aand4: case aand8:
+					case aor1: case aor2: case aor4: case aor8:
+					case axor1: case axor2: case axor4: case axor8: {
 						uint64_t
 							reg1 = 0,
 							reg2 = 0
@@ -836,7 +880,8 @@ static void tagha_asm_assemble(void)
 						break;
 					}
 					
-					case st1: case st2: case st4: case st8: {
+					case st1: case st2: case st4: case st8:
+					case ast1: case ast2: case ast4: case ast8: {
 						uint64_t
 							reg1 = 0,
 							reg2 = 0
@@ -942,7 +987,7 @@ static void tagha_asm_assemble(void)
 					}
 					
 					/// no operands
-					case ret: case halt: case nop: case pushlr: case poplr: {
+					case ret: case halt: case nop: case pushlr: case poplr: case fence: case yield: {
 						tagha_asm.pc += tagha_instr_gen(&func->data, *opcode);
 					}
 					default: break;
@@ -977,14 +1022,15 @@ static void tagha_asm_assemble(void)
 	
 	uint32_t mem_region_size = memnode_size + tagha_ptr_size * 2;
 	
+	/// symbol hash index is stored in the module, only the item & key arrays are allocated.
 	mem_region_size += (tagha_sym_arr_size * tagha_asm.funcs.map.count + memnode_size);
-	mem_region_size += ((tagha_ptr_size * tagha_asm.funcs.map.count * 3) + (memnode_size * 3));
+	mem_region_size += ((tagha_ptr_size * tagha_asm.funcs.map.count) + memnode_size);
 	
 	mem_region_size += (tagha_sym_arr_size * tagha_asm.vars.map.count + memnode_size);
-	mem_region_size += ((tagha_ptr_size * tagha_asm.vars.map.count * 3) + (memnode_size * 3));
+	mem_region_size += ((tagha_ptr_size * tagha_asm.vars.map.count) + memnode_size);
 	
 	struct TaghaModGen modgen = tagha_mod_gen_create();
-	tagha_mod_gen_write_header(&modgen, tagha_asm.opstacksize, tagha_asm.callstacksize, tagha_asm.heapsize+ ( uint32_t )harbol_align_size(mem_region_size, 8), 0);
+	tagha_mod_gen_write_header(&modgen, tagha_asm.opstacksize, tagha_asm.callstacksize, tagha_asm.heapsize+ ( uint32_t )harbol_align_size(mem_region_size, 8), tagha_asm.flags);
 	
 	for( size_t i=0; i<tagha_asm.funcs.map.count; i++ ) {
 		const struct HarbolKeyVal *node = harbol_linkmap_index_get_kv(&tagha_asm.funcs, i);
@@ -38,6 +38,12 @@ bool tagha_disasm_module(const char filename[restrict static 1])
 	harbol_string_add_format(&header, "$callstack_size        %d\n", hdr->callstacksize / sizeof(uintptr_t));
 	harbol_string_add_format(&header, ";; total stacks size   '%d'\n\n", hdr->stacksize);
 	harbol_string_add_format(&header, "$heap_size     %d\n", hdr->heapsize);
+	if( hdr->flags & TAGHA_MODULE_HEAP_TLSF )
+		harbol_string_add_cstr(&header, "$heap_allocator tlsf\n");
+	else if( hdr->flags & TAGHA_MODULE_HEAP_SLAB )
+		harbol_string_add_cstr(&header, "$heap_allocator slab\n");
+	if( hdr->flags & TAGHA_MODULE_HEAP_ARENA )
+		harbol_string_add_cstr(&header, "$heap_arena\n");
 	harbol_string_add_format(&header, ";; total memory usage: '%d' bytes\n\n", hdr->memsize);
 	
 	const uint32_t func_table_size = hdr->func_count;
@@ -80,7 +86,7 @@ bool tagha_disasm_module(const char filename[restrict static 1])
 				const uint8_t opcode = *pc.uint8++;
 				switch( opcode ) {
 					/// opcodes that have no operands.
-					case ret: case halt: case nop: case pushlr: case poplr: {
+					case ret: case halt: case nop: case pushlr: case poplr: case fence: case yield: {
 						harbol_string_add_format(&bc_funcs, "    %-10s ;; offset: %" PRIuPTR "\n", opcode_strs[opcode], ( uintptr_t )pc.uint8 - offs);
 						break;
 					}
@@ -166,14 +172,20 @@ bool tagha_disasm_module(const char filename[restrict static 1])
 						const uint32_t regid = *pc.uint8++;
 						const uint32_t label = *pc.uint16++;
 						const uintptr_t addr2 = ( uintptr_t )pc.uint8 - offs;
-						const struct HarbolString *const label_name = harbol_vector_get((opcode==ldvar) ? &var_names : &func_names, (opcode==ldvar) ? label : label - 1);
+						const struct HarbolString *const label_name = harbol_vector_get((opcode==ldvar) ? &var_names : &func_names, label);
 						
 						harbol_string_add_format(&bc_funcs, "    %-10s r%u, %s ;; offset: %" PRIuPTR " - %" PRIuPTR "\n", opcode_strs[opcode], regid, label_name->cstr, addr, addr2);
 						break;
 					}
 					
 					case lea:
-					case ld1: case ld2: case ld4: case ld8: case ldu1: case ldu2: case ldu4: {
+					case ld1: case ld2: case ld4: case ld8: case ldu1: case ldu2: case ldu4:
+					case ald1: case ald2: case ald4: case ald8:
+					case acas1: case acas2: case acas4: case acas8:
+					case aadd1: case aadd2: case aadd4: case aadd8:
+					case aand1: case aand2: case aand4: case aand8:
+					case aor1: case aor2: case aor4: case aor8:
+					case axor1: case axor2: case axor4: case axor8: {
 						const uintptr_t addr = ( uintptr_t )pc.uint8 - offs;
 						const uint32_t dst = *pc.uint8++;
 						const uint32_t src = *pc.uint8++;
@@ -185,7 +197,8 @@ bool tagha_disasm_module(const char filename[restrict static 1])
 						break;
 					}
 					
-					case st1: case st2: case st4: case st8: {
+					case st1: case st2: case st4: case st8:
+					case ast1: case ast2: case ast4: case ast8: {
 						const uintptr_t addr = ( uintptr_t )pc.uint8 - offs;
 						const uint32_t dst = *pc.uint8++;
 						const uint32_t src = *pc.uint8++;
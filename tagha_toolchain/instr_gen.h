@@ -84,7 +84,14 @@ static inline size_t tagha_instr_gen(struct HarbolByteBuf *const tbc, const enum
 		/// two bytes + signed 2-byte int.
 		case lea:
 		case ld1: case ld2: case ld4: case ld8: case ldu1: case ldu2: case ldu4:
-		case st1: case st2: case st4: case st8: {
+		case st1: case st2: case st4: case st8:
+		case ald1: case ald2: case ald4: case ald8:
+		case acas1: case acas2: case acas4: case acas8:
+		case aadd1: case aadd2: case aadd4: case aadd8:
+		case aand1: case aand2: case aand4: case aand8:
+		case aor1: case aor2: case aor4: case aor8:
+		case axor1: case axor2: case axor4: case axor8:
+		case ast1: case ast2: case ast4: case ast8: {
 			if( tbc != NULL ) {
 				const int oper1     = va_arg(ap, int);
 				const int oper2     = va_arg(ap, int);
@@ -121,7 +128,7 @@ static inline size_t tagha_instr_gen(struct HarbolByteBuf *const tbc, const enum
 		}
 		
 		/// no operands.
-		case ret: case halt: case nop: case pushlr: case poplr: case MaxOps: {
+		case ret: case halt: case nop: case pushlr: case poplr: case fence: case yield: case MaxOps: {
 			break;
 		}
 	}
@@ -0,0 +1,332 @@
+#include "../libharbol/harbol.h"
+#include "../../tagha/tagha.h"
+#include "../module_gen.h"
+
+
+/** Tagha Static Linker
+ * merges several .tbc modules into one:
+ * extern funcs are resolved to the function defined by another input module,
+ * natives & globals with the same name are merged into one entry,
+ * `call`, `ldfn` & `ldvar` operands are rewritten to the merged table indexes.
+ */
+
+struct TaghaLinkItem {
+	const uint8_t *data;   /// bytecode or var data inside the input file.
+	uint32_t flags, data_len;
+	size_t module;         /// input module that defined it, used to remap its bytecode.
+};
+
+struct TaghaLinkInput {
+	uint8_t *filedata;
+	const char *filename;
+	uint32_t *func_map, *var_map; /// input table index -> merged table index.
+};
+
+static struct {
+	struct HarbolLinkMap funcs, vars;
+	struct TaghaLinkInput *inputs;
+	size_t input_count;
+	uint32_t opstacksize, callstacksize, heapsize, flags;
+	bool err : 1;
+} tagha_linker;
+
+
+static bool tagha_linker_add_func(const size_t m, const uint32_t i, const char name[static 1], const struct TaghaLinkItem *const item)
+{
+	struct TaghaLinkInput *const input = &tagha_linker.inputs[m];
+	struct TaghaLinkItem *const prev = harbol_linkmap_key_get(&tagha_linker.funcs, name);
+	if( prev==NULL ) {
+		harbol_linkmap_insert(&tagha_linker.funcs, name, ( void* )item);
+	} else if( item->flags & TAGHA_FLAG_EXTERN ) {
+		/// extern of an already seen func, nothing to merge.
+	} else if( prev->flags & TAGHA_FLAG_EXTERN ) {
+		/// resolve the extern into this definition.
+		*prev = *item;
+	} else if( prev->flags != item->flags || item->flags==0 ) {
+		fprintf(stderr, "Tagha Linker Error: **** function '%s' in '%s' is already defined by '%s'. ****\n", name, input->filename, tagha_linker.inputs[prev->module].filename);
+		return false;
+	}
+	/// natives of the same name are merged.
+	input->func_map[i] = ( uint32_t )harbol_linkmap_get_key_index(&tagha_linker.funcs, name);
+	return true;
+}
+
+static bool tagha_linker_add_var(const size_t m, const uint32_t i, const char name[static 1], const struct TaghaLinkItem *const item)
+{
+	struct TaghaLinkInput *const input = &tagha_linker.inputs[m];
+	const struct TaghaLinkItem *const prev = harbol_linkmap_key_get(&tagha_linker.vars, name);
+	if( prev==NULL ) {
+		harbol_linkmap_insert(&tagha_linker.vars, name, ( void* )item);
+	} else if( prev->data_len != item->data_len ) {
+		fprintf(stderr, "Tagha Linker Error: **** global '%s' in '%s' has a different size than in '%s'. ****\n", name, input->filename, tagha_linker.inputs[prev->module].filename);
+		return false;
+	} else if( memcmp(prev->data, item->data, item->data_len) ) {
+		fprintf(stderr, "Tagha Linker Warning: **** global '%s' in '%s' has a different initializer than in '%s', keeping the first. ****\n", name, input->filename, tagha_linker.inputs[prev->module].filename);
+	}
+	input->var_map[i] = ( uint32_t )harbol_linkmap_get_key_index(&tagha_linker.vars, name);
+	return true;
+}
+
+static bool tagha_linker_read_module(const size_t m)
+{
+	struct TaghaLinkInput *const input = &tagha_linker.inputs[m];
+	input->filedata = make_buffer_from_binary(input->filename);
+	if( input->filedata==NULL ) {
+		fprintf(stderr, "Tagha Linker Error: **** Couldn't load Tagha Module file: '%s' ****\n", input->filename);
+		return false;
+	}
+	
+	const struct TaghaModuleHeader *const hdr = ( const struct TaghaModuleHeader* )input->filedata;
+	if( hdr->magic != TAGHA_MAGIC_VERIFIER ) {
+		fprintf(stderr, "Tagha Linker Error: **** Invalid Tagha Module file: '%s' ****\n", input->filename);
+		return false;
+	}
+	
+	/// stacks are reused by every merged module, heaps aren't.
+	if( tagha_linker.opstacksize < hdr->opstacksize )
+		tagha_linker.opstacksize = hdr->opstacksize;
+	if( tagha_linker.callstacksize < hdr->callstacksize )
+		tagha_linker.callstacksize = hdr->callstacksize;
+	tagha_linker.heapsize += hdr->heapsize;
+	tagha_linker.flags |= hdr->flags;
+	
+	input->func_map = calloc(hdr->func_count + 1, sizeof *input->func_map);
+	input->var_map  = calloc(hdr->var_count + 1, sizeof *input->var_map);
+	if( input->func_map==NULL || input->var_map==NULL ) {
+		fprintf(stderr, "Tagha Linker Error: **** Unable to allocate index maps for '%s' ****\n", input->filename);
+		return false;
+	}
+	
+	union HarbolBinIter iter = { .uint8 = input->filedata + hdr->funcs_offset };
+	for( uint32_t i=0; i<hdr->func_count; i++ ) {
+		const struct TaghaItemEntry *const entry = iter.ptr;
+		iter.uint8 += sizeof *entry;
+		const char *const name = iter.string;
+		iter.uint8 += entry->name_len;
+		const struct TaghaLinkItem item = {
+			.data     = iter.uint8,
+			.flags    = entry->flags,
+			.data_len = entry->flags ? 0 : entry->data_len,
+			.module   = m
+		};
+		if( !tagha_linker_add_func(m, i, name, &item) )
+			return false;
+		if( !entry->flags )
+			iter.uint8 += entry->data_len;
+	}
+	
+	iter.uint8 = input->filedata + hdr->vars_offset;
+	for( uint32_t i=0; i<hdr->var_count; i++ ) {
+		const struct TaghaItemEntry *const entry = iter.ptr;
+		iter.uint8 += sizeof *entry;
+		const char *const name = iter.string;
+		iter.uint8 += entry->name_len;
+		const struct TaghaLinkItem item = {
+			.data     = iter.uint8,
+			.flags    = entry->flags,
+			.data_len = entry->data_len,
+			.module   = m
+		};
+		if( !tagha_linker_add_var(m, i, name, &item) )
+			return false;
+		iter.uint8 += entry->data_len;
+	}
+	return true;
+}
+
+/// copies a bytecode func & rewrites its func/var table operands to the merged indexes.
+static bool tagha_linker_relocate(struct HarbolByteBuf *const restrict code, const char name[restrict static 1], const struct TaghaLinkItem *const restrict item)
+{
+	const struct TaghaLinkInput *const input = &tagha_linker.inputs[item->module];
+	harbol_bytebuffer_insert_obj(code, item->data, item->data_len);
+	
+	uint8_t *pc = code->table;
+	const uint8_t *const end = code->table + code->count;
+	while( pc < end ) {
+		const uint8_t opcode = *pc++;
+		switch( opcode ) {
+			/// no operands.
+			case ret: case halt: case nop: case pushlr: case poplr: case fence: case yield:
+				break;
+			
+			/// u8 operand.
+			case alloc: case redux: case setelen:
+			case neg: case fneg:
+			case bit_not: case setc:
+			case callr:
+			case f32tof64: case f64tof32:
+			case itof64: case itof32:
+			case f64toi: case f32toi:
+			case vneg: case vfneg:
+			case vnot:
+				pc += 1;
+				break;
+			
+			/// two u8 operands.
+			case mov:
+			case add: case sub: case mul: case idiv: case mod:
+			case fadd: case fsub: case fmul: case fdiv:
+			case bit_and: case bit_or: case bit_xor: case shl: case shr: case shar:
+			case ilt: case ile: case ult: case ule: case cmp: case flt: case fle:
+			case vmov:
+			case vadd: case vsub: case vmul: case vdiv: case vmod:
+			case vfadd: case vfsub: case vfmul: case vfdiv:
+			case vand: case vor: case vxor: case vshl: case vshr: case vshar:
+			case vcmp: case vilt: case vile: case vult: case vule: case vflt: case vfle:
+				pc += 2;
+				break;
+			
+			/// u16 func index + 1.
+			case call: {
+				uint16_t index; memcpy(&index, pc, sizeof index);
+				index = ( uint16_t )(input->func_map[index - 1] + 1);
+				memcpy(pc, &index, sizeof index);
+				pc += sizeof index;
+				break;
+			}
+			
+			/// u16 imm.
+			case setvlen:
+				pc += 2;
+				break;
+			
+			/// u8 reg + u16 offset.
+			case lra:
+				pc += 3;
+				break;
+			
+			/// u8 reg + u16 func or var index.
+			case ldvar: case ldfn: {
+				pc += 1;
+				uint16_t index; memcpy(&index, pc, sizeof index);
+				index = ( uint16_t )((opcode==ldvar) ? input->var_map[index] : input->func_map[index]);
+				memcpy(pc, &index, sizeof index);
+				pc += sizeof index;
+				break;
+			}
+			
+			/// two u8 regs + i16 offset.
+			case lea:
+			case ld1: case ld2: case ld4: case ld8: case ldu1: case ldu2: case ldu4:
+			case st1: case st2: case st4: case st8:
+			case ald1: case ald2: case ald4: case ald8:
+			case acas1: case acas2: case acas4: case acas8:
+			case aadd1: case aadd2: case aadd4: case aadd8:
+			case aand1: case aand2: case aand4: case aand8:
+			case aor1: case aor2: case aor4: case aor8:
+			case axor1: case axor2: case axor4: case axor8:
+			case ast1: case ast2: case ast4: case ast8:
+				pc += 4;
+				break;
+			
+			/// i32 relative offset, unaffected by merging.
+			case jmp: case jz: case jnz:
+				pc += 4;
+				break;
+			
+			/// u8 reg + u64 imm.
+			case movi:
+				pc += 9;
+				break;
+			
+			default:
+				fprintf(stderr, "Tagha Linker Error: **** unknown opcode '%u' in function '%s' of '%s'. ****\n", opcode, name, input->filename);
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool tagha_linker_link(const char outfile[static 1])
+{
+	for( size_t m=0; m<tagha_linker.input_count; m++ )
+		if( !tagha_linker_read_module(m) )
+			return false;
+	
+	/// call, ldfn & ldvar only hold 16-bit indexes.
+	if( tagha_linker.funcs.map.count >= UINT16_MAX || tagha_linker.vars.map.count > UINT16_MAX ) {
+		fprintf(stderr, "Tagha Linker Error: **** merged module has too many functions (%zu) or globals (%zu). ****\n", tagha_linker.funcs.map.count, tagha_linker.vars.map.count);
+		return false;
+	}
+	
+	struct TaghaModGen modgen = tagha_mod_gen_create();
+	tagha_mod_gen_write_header(&modgen, tagha_linker.opstacksize, tagha_linker.callstacksize, tagha_linker.heapsize, tagha_linker.flags);
+	
+	bool result = true;
+	for( size_t i=0; i<tagha_linker.funcs.map.count && result; i++ ) {
+		const struct HarbolKeyVal *const node = harbol_linkmap_index_get_kv(&tagha_linker.funcs, i);
+		const struct TaghaLinkItem *const item = harbol_linkmap_index_get(&tagha_linker.funcs, i);
+		struct HarbolByteBuf code = harbol_bytebuffer_create();
+		if( item->flags==0 )
+			result = tagha_linker_relocate(&code, node->key.cstr, item);
+		else if( item->flags & TAGHA_FLAG_EXTERN )
+			fprintf(stderr, "Tagha Linker Warning: **** extern function '%s' is left unresolved. ****\n", node->key.cstr);
+		tagha_mod_gen_write_func(&modgen, item->flags, node->key.cstr, &code);
+		harbol_bytebuffer_clear(&code);
+	}
+	
+	for( size_t i=0; i<tagha_linker.vars.map.count && result; i++ ) {
+		const struct HarbolKeyVal *const node = harbol_linkmap_index_get_kv(&tagha_linker.vars, i);
+		const struct TaghaLinkItem *const item = harbol_linkmap_index_get(&tagha_linker.vars, i);
+		struct HarbolByteBuf datum = harbol_bytebuffer_create();
+		harbol_bytebuffer_insert_obj(&datum, item->data, item->data_len);
+		tagha_mod_gen_write_var(&modgen, item->flags, node->key.cstr, &datum);
+		harbol_bytebuffer_clear(&datum);
+	}
+	
+	if( result )
+		result = tagha_mod_gen_create_file(&modgen, outfile);
+	else {
+		/// still finalize to release the generator's buffers.
+		struct HarbolByteBuf unused = tagha_mod_gen_buffer(&modgen);
+		harbol_bytebuffer_clear(&unused);
+	}
+	return result;
+}
+
+static void tagha_linker_cleanup(void)
+{
+	for( size_t m=0; m<tagha_linker.input_count; m++ ) {
+		free(tagha_linker.inputs[m].filedata);
+		free(tagha_linker.inputs[m].func_map);
+		free(tagha_linker.inputs[m].var_map);
+	}
+	free(tagha_linker.inputs);
+	harbol_linkmap_clear(&tagha_linker.funcs, NULL);
+	harbol_linkmap_clear(&tagha_linker.vars, NULL);
+	memset(&tagha_linker, 0, sizeof tagha_linker);
+}
+
+NO_NULL int main(const int argc, char *argv[restrict static 1])
+{
+	if( argc<=1 ) {
+		fprintf(stderr, "Tagha Linker - usage: %s [-o output.tbc] [.tbc file...]\n", argv[0]);
+		return 1;
+	} else if( !strcmp(argv[1], "--help") ) {
+		puts("Tagha Linker - Tagha Runtime Environment Toolkit\nTo merge tbc modules into one, supply the module names as command-line arguments to the program.\nExternal functions defined by another given module become local functions.\nExample: './tagha_linker -o bundle.tbc main.tbc lib.tbc'");
+		return 0;
+	} else if( !strcmp(argv[1], "--version") ) {
+		puts("Tagha Linker Version 1.0.0");
+		return 0;
+	}
+	
+	const char *outfile = "a.tbc";
+	tagha_linker.funcs  = harbol_linkmap_create(sizeof(struct TaghaLinkItem));
+	tagha_linker.vars   = harbol_linkmap_create(sizeof(struct TaghaLinkItem));
+	tagha_linker.inputs = calloc(( size_t )argc, sizeof *tagha_linker.inputs);
+	if( tagha_linker.inputs==NULL )
+		return 1;
+	
+	for( int i=1; i<argc; i++ ) {
+		if( !strcmp(argv[i], "-o") && i + 1 < argc ) {
+			outfile = argv[++i];
+		} else {
+			tagha_linker.inputs[tagha_linker.input_count++].filename = argv[i];
+		}
+	}
+	
+	const bool linked = tagha_linker.input_count > 0 && tagha_linker_link(outfile);
+	printf("Tagha Linker: file '%s' %s\n", outfile, linked ? "successfully generated" : "generation failed");
+	tagha_linker_cleanup();
+	return linked ? 0 : 1;
+}
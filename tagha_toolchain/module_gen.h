@@ -12,6 +12,7 @@ extern "C" {
 struct TaghaModGen {
 	struct TaghaModuleHeader hdr;
 	struct HarbolByteBuf var_data, func_data;
+	struct HarbolByteBuf var_hashes, func_hashes; /// uint32_t `tagha_sym_hash` per symbol.
 };
 
 
@@ -20,7 +21,10 @@ static inline struct TaghaModGen tagha_mod_gen_create(void)
 	struct TaghaModGen module = {0};
 	module.func_data = harbol_bytebuffer_create();
 	module.var_data  = harbol_bytebuffer_create();
+	module.func_hashes = harbol_bytebuffer_create();
+	module.var_hashes  = harbol_bytebuffer_create();
 	module.hdr.magic = TAGHA_MAGIC_VERIFIER;
+	module.hdr.version = TAGHA_MODULE_VERSION;
 	return module;
 }
 
@@ -67,6 +71,7 @@ static inline NEVER_NULL(1,3) void tagha_mod_gen_write_func(struct TaghaModGen *
 		harbol_bytebuffer_append(&mod->func_data, bytecode);
 		harbol_bytebuffer_insert_zeros(&mod->func_data, data_len_diff);
 	}
+	harbol_bytebuffer_insert_int32(&mod->func_hashes, tagha_sym_hash(name));
 	mod->hdr.func_count++;
 }
 
@@ -75,8 +80,9 @@ static inline NEVER_NULL(1,3,4) void tagha_mod_gen_write_var(struct TaghaModGen
 	uint32_t entry_size = sizeof(struct TaghaItemEntry);
 	const uint32_t name_len = ( uint32_t )strlen(name) + 1;
 	const uint32_t data_len = ( uint32_t )datum->count;
-	const uint32_t name_len_diff = ( uint32_t )harbol_align_size(name_len, 4) - name_len;
-	const uint32_t data_len_diff = ( uint32_t )harbol_align_size(data_len, 4) - data_len;
+	/// entries stay 8 byte aligned so the var's data is too, atomic ops need it.
+	const uint32_t name_len_diff = ( uint32_t )harbol_align_size(name_len, sizeof(union TaghaVal)) - name_len;
+	const uint32_t data_len_diff = ( uint32_t )harbol_align_size(data_len, sizeof(union TaghaVal)) - data_len;
 	entry_size += name_len + data_len + name_len_diff + data_len_diff;
 	
 	/// entry size
@@ -99,9 +105,35 @@ static inline NEVER_NULL(1,3,4) void tagha_mod_gen_write_var(struct TaghaModGen
 	harbol_bytebuffer_append(&mod->var_data, datum);
 	harbol_bytebuffer_insert_zeros(&mod->var_data, data_len_diff);
 	
+	harbol_bytebuffer_insert_int32(&mod->var_hashes, tagha_sym_hash(name));
 	mod->hdr.var_count++;
 }
 
+/// writes the open addressing slots in the layout the loader uses in place.
+static inline NO_NULL void __tagha_mod_gen_write_sym_index(struct HarbolByteBuf *const restrict final_tbc, const struct HarbolByteBuf *const restrict hashbuf)
+{
+	const uint32_t *const hashes = ( const uint32_t* )hashbuf->table;
+	const uint32_t len = ( uint32_t )(hashbuf->count / sizeof *hashes);
+	const uint32_t slot_count = tagha_sym_slot_count(len);
+	const uint32_t mask = slot_count - 1;
+	
+	struct HarbolByteBuf index = harbol_bytebuffer_create();
+	harbol_bytebuffer_insert_zeros(&index, sizeof(struct TaghaSymSlot) * slot_count);
+	struct TaghaSymSlot *const slots = ( struct TaghaSymSlot* )index.table;
+	for( uint32_t i=0; i<slot_count; i++ )
+		slots[i].index = UINT32_MAX;
+	
+	/// insert in table order so the first of any duplicate keys is found first.
+	for( uint32_t i=0; i<len; i++ ) {
+		uint32_t n = hashes[i] & mask;
+		while( slots[n].index != UINT32_MAX )
+			n = (n + 1) & mask;
+		slots[n] = (struct TaghaSymSlot){ hashes[i], i };
+	}
+	harbol_bytebuffer_append(final_tbc, &index);
+	harbol_bytebuffer_clear(&index);
+}
+
 static inline NO_NULL struct HarbolByteBuf __tagha_mod_gen_finalize(struct TaghaModGen *const mod)
 {
 	struct HarbolByteBuf final_tbc = harbol_bytebuffer_create();
@@ -110,20 +142,25 @@ static inline NO_NULL struct HarbolByteBuf __tagha_mod_gen_finalize(struct Tagha
 	mod->hdr.funcs_offset = sizeof mod->hdr;
 	mod->hdr.vars_offset  = mod->hdr.funcs_offset + mod->func_data.count;
 	mod->hdr.mem_offset   = mod->hdr.vars_offset  + mod->var_data.count;
+	mod->hdr.index_offset = mod->hdr.mem_offset;
 	
 	/// add the header.
 	harbol_bytebuffer_insert_obj(&final_tbc, &mod->hdr, sizeof mod->hdr);
 	
 	/// build func table & var table.
+	/// memory region isn't stored, the loader allocates `memsize` bytes.
 	harbol_bytebuffer_append(&final_tbc, &mod->func_data);
 	harbol_bytebuffer_append(&final_tbc, &mod->var_data);
 	
-	/// build memory region.
-	harbol_bytebuffer_insert_zeros(&final_tbc, mod->hdr.memsize);
+	/// symbol hash index, func index first.
+	__tagha_mod_gen_write_sym_index(&final_tbc, &mod->func_hashes);
+	__tagha_mod_gen_write_sym_index(&final_tbc, &mod->var_hashes);
 	
 	/// free data.
 	harbol_bytebuffer_clear(&mod->func_data);
 	harbol_bytebuffer_clear(&mod->var_data);
+	harbol_bytebuffer_clear(&mod->func_hashes);
+	harbol_bytebuffer_clear(&mod->var_hashes);
 	
 	return final_tbc;
 }
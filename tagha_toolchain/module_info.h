@@ -34,6 +34,16 @@ static inline NO_NULL void tagha_module_print_callstack(const struct TaghaModule
 	}
 }
 
+static inline NO_NULL void tagha_module_print_heap_stats(const struct TaghaModule *const mod, FILE *const stream)
+{
+	struct TaghaHeapStats stats;
+	tagha_module_heap_stats(mod, &stats);
+	fprintf(stream, "Tagha Heap::\nCapacity: %zu bytes\nIn Use: %zu bytes (peak %zu bytes)\nFree: %zu bytes (largest block %zu bytes)\nFragmentation: %.1f%%\n", stats.capacity, stats.in_use, stats.peak_in_use, stats.free, stats.largest_free, stats.fragmentation * 100.0);
+	for( size_t i=0; i<HARBOL_STATS_BUCKETS; i++ )
+		if( stats.allocs[i] != 0 || stats.frees[i] != 0 )
+			fprintf(stream, "blocks [%zu, %zu) bytes : %zu allocs, %zu frees\n", ( size_t )1 << i, ( size_t )2 << i, stats.allocs[i], stats.frees[i]);
+}
+
 #ifdef __cplusplus
 } /** extern "C" */
 #endif
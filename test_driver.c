@@ -3,6 +3,7 @@
 #include <time.h>
 
 #include "tagha/tagha.h"
+#include "tagha/loop/loop.h"
 #include "tagha_toolchain/module_info.h"
 
 /// struct TaghaModule *tagha_module_new_from_file(const char filename[]);
@@ -48,6 +49,49 @@ static NO_NULL union TaghaVal native_add_one(struct TaghaModule *const module, c
 	return ( union TaghaVal ){ .int32 = params[0].int32 + 1 };
 }
 
+/// bool suspend(void);
+static NO_NULL union TaghaVal native_suspend(struct TaghaModule *const module, const union TaghaVal params[const])
+{
+	( void )params;
+	return ( union TaghaVal ){ .b00l = tagha_module_suspend(module) };
+}
+
+/// int add_one_async(const int n); the host hands the result over when it resumes the script.
+static struct {
+	union TaghaVal result;
+	bool pending;
+} async_op;
+
+static NO_NULL union TaghaVal native_add_one_async(struct TaghaModule *const module, const union TaghaVal params[const static 1])
+{
+	const union TaghaVal result = { .int32 = params[0].int32 + 1 };
+	if( !tagha_module_suspend(module) )
+		return result;
+	
+	async_op.result  = result;
+	async_op.pending = true;
+	return ( union TaghaVal ){ 0 };
+}
+
+/// void *malloc(size_t size);
+static NO_NULL union TaghaVal native_malloc(struct TaghaModule *const module, const union TaghaVal params[const static 1])
+{
+	return ( union TaghaVal ){ .uintptr = tagha_module_heap_alloc(module, params[0].size) };
+}
+
+/// void *malloc_uninit(size_t size);
+static NO_NULL union TaghaVal native_malloc_uninit(struct TaghaModule *const module, const union TaghaVal params[const static 1])
+{
+	return ( union TaghaVal ){ .uintptr = tagha_module_heap_alloc_uninit(module, params[0].size) };
+}
+
+/// void free(void *ptr);
+static NO_NULL union TaghaVal native_free(struct TaghaModule *const module, const union TaghaVal params[const static 1])
+{
+	tagha_module_heap_free(module, params[0].uintptr);
+	return ( union TaghaVal ){ 0 };
+}
+
 /*
 /// int strcpy(char *str1, const char *str2);
 static NO_NULL union TaghaVal native_strcpy(struct TaghaModule *const restrict module, const union TaghaVal params[const restrict static 2])
@@ -88,39 +132,90 @@ static NO_NULL union TaghaVal native_alloca(struct TaghaModule *const module, co
 	return ( union TaghaVal ){ .uintptr = (alloc_space < module->opstack) ? NIL : alloc_space };
 }
 
+/// prints how each loop call of `loop_task` ended.
+static void on_loop_task_done(void *const data, struct TaghaModule *const module, const int err, const union TaghaVal result)
+{
+	( void )module;
+	printf("loop call %zu result => %i | err? '%s'\n", ( size_t )( uintptr_t )data, result.int32, ( err==TaghaErrNone ) ? "None" : ( err==TaghaErrSuspended ) ? "Suspended" : "Other");
+}
+
 
 NO_NULL int main(const int argc, char *argv[const restrict static 1])
 {
 	( void )argc;
 	if( argv[1]==NULL ) {
-		printf("[TaghaVM (v%s) Test Host App Usage]: './%s' '.tbc filepath' \n", TAGHA_VERSION_STRING, argv[0]);
+		printf("[TaghaVM (v%s) Test Host App Usage]: './%s' '.tbc filepath' ['library .tbc filepaths'...] \n", TAGHA_VERSION_STRING, argv[0]);
 		return 1;
 	} else {
-		struct TaghaModule *module = tagha_module_new_from_file(argv[1]);
+		/// registered once per process, modules loaded by scripts bind them on first call.
+		tagha_native_register_all(( const struct TaghaNative[] ){
+			{"tagha_module_new_from_file", &native_tagha_module_new_from_file},
+			{"tagha_module_free",          &native_tagha_module_free},
+			{"tagha_module_get_func",      &native_tagha_module_get_func},
+			{"tagha_module_link_module",   &native_tagha_module_link_module},
+			{"puts",                       &native_puts},
+			{"fgets",                      &native_fgets},
+			//{"strcpy",                     &native_strcpy},
+			{"add_one",                    &native_add_one},
+			{"suspend",                    &native_suspend},
+			{"add_one_async",              &native_add_one_async},
+			{"malloc",                     &native_malloc},
+			{"malloc_uninit",              &native_malloc_uninit},
+			{"free",                       &native_free},
+			{NULL, NULL}
+		});
+		tagha_native_register_all(tagha_thread_natives);
+		tagha_native_register_all(tagha_loop_natives);
+		
+		/// `parallel_for` shares these between the main module's calls.
+		struct HarbolThreadPool pool;
+		const bool has_pool = harbol_thread_pool_init(&pool, 3);
+		
+		struct TaghaSys sys = tagha_sys_create();
+		/// heaps may grow past their `$heap_size` up to 16 MiB.
+		sys.opts.heap_limit = 16 * 1024 * 1024;
+		struct TaghaModule *const module = tagha_sys_load_module(&sys, argv[1]);
+		/// extra modules are libraries, the sys links their externs with the main module.
+		for( char **lib = argv + 2; *lib != NULL; lib++ )
+			tagha_sys_load_module(&sys, *lib);
+		
 		if( module != NULL ) {
-			tagha_module_link_natives(module, ( const struct TaghaNative[] ){
-				{"tagha_module_new_from_file", &native_tagha_module_new_from_file},
-				{"tagha_module_free",          &native_tagha_module_free},
-				{"tagha_module_get_func",      &native_tagha_module_get_func},
-				{"tagha_module_link_module",   &native_tagha_module_link_module},
-				{"puts",                       &native_puts},
-				{"fgets",                      &native_fgets},
-				//{"strcpy",                     &native_strcpy},
-				{"add_one",                    &native_add_one},
-				{NULL, NULL}
-			});
-			
 			tagha_module_link_ptr(module, "stdin",  ( uintptr_t )stdin);
 			tagha_module_link_ptr(module, "stderr", ( uintptr_t )stderr);
 			tagha_module_link_ptr(module, "stdout", ( uintptr_t )stdout);
 			tagha_module_link_ptr(module, "self",   ( uintptr_t )module);
+			if( has_pool )
+				tagha_module_set_pool(module, &pool);
+			
+			union TaghaVal r = { .int32 = tagha_module_run(module, 0, NULL) };
+			/// scripts that yield or get suspended by a native are resumed until they finish.
+			while( tagha_module_suspended(module) ) {
+				if( async_op.pending ) {
+					async_op.pending = false;
+					tagha_module_resume_with(module, async_op.result, &r);
+				} else {
+					tagha_module_resume(module, &r);
+				}
+			}
+			printf("result => %i | err? '%s'\n", r.int32, tagha_module_get_err(module));
 			
-			const int r = tagha_module_run(module, 0, NULL);
-			printf("result => %i | err? '%s'\n", r, tagha_module_get_err(module));
+			/// scripts with a `loop_task` get it spawned twice on an event loop,
+			/// the second call finds the module suspended on the first.
+			const TaghaFunc loop_task = tagha_module_get_func(module, "loop_task");
+			struct TaghaLoop loop;
+			if( loop_task != NULL && tagha_loop_init(&loop, 0, 0) ) {
+				for( size_t i=0; i<2; i++ )
+					tagha_loop_spawn(&loop, module, loop_task, 0, NULL, &on_loop_task_done, ( void* )( uintptr_t )i);
+				tagha_loop_run(&loop);
+				tagha_loop_clear(&loop);
+			}
 			tagha_module_print_opstack(module, stdout);
 			tagha_module_print_callstack(module, stdout);
-			
-			tagha_module_free(&module);
+			tagha_module_print_heap_stats(module, stdout);
 		}
+		tagha_sys_clear(&sys);
+		if( has_pool )
+			harbol_thread_pool_clear(&pool);
+		tagha_native_registry_clear();
 	}
 }